@@ -11,6 +11,8 @@ from tqdm import tqdm, trange
 
 import multiprocessing
 
+import struct
+
 import ephem
 from skyfield.api import S, EarthSatellite
 from skyfield.api import load
@@ -27,6 +29,7 @@ from datetime import timezone
 ### constellation utilities
 
 KEP_CONS = 3.9861e14
+LIGHT_SPEED = 299792.458 # in km/s
 RUNS = 1 # how many orbiting periods to simulate
 
 ts = load.timescale()
@@ -71,6 +74,11 @@ def getMaxDistance(height, angle):
     ar = math.asin(r*math.sin(arh)/(r+h))
     return (r+h)*math.sin(ephem.pi-arh-ar)/math.sin(arh)
 
+# propagation delay (in microseconds) over a given distance (in km)
+def getDelay(distance):
+    global LIGHT_SPEED
+    return int(round(distance/LIGHT_SPEED*1000000))
+
 def getSatId(orbitNum, satNum): # name a satellite
     return 'sat-%d-%d' % (orbitNum, satNum)
 
@@ -661,6 +669,52 @@ def storeISLs(scenario, dir):
     ISLsFile.writelines(content)
     ISLsFile.close()
 
+# store ISL delays at each epoch, delays in each row follow the order of ISLs.csv
+def storeISLDelays(scenario, dir):
+    print('Storing ISL delays...')
+    content = ['Time,Delays\n']
+    edges = list(scenario.constellation.snapshots[0].edges)
+    for epoch in tqdm(range(len(scenario.constellation.snapshots))):
+        G = scenario.constellation.snapshots[epoch]
+        delays = [str(getDelay(G[edge[0]][edge[1]]['weight'])) for edge in edges]
+        line = ','.join([str(epoch), '|'.join(delays)])
+        line += '\n'
+        content.append(line)
+    delaysFile = open('%sISLDelays.csv'%(dir), 'w')
+    delaysFile.writelines(content)
+    delaysFile.close()
+
+# delay of the user link between each GT and its access satellite at each epoch, 0 if not attached
+def getUserLinkDelays(scenario):
+    infoType = 'user link delays'
+    if infoType in scenario.store:
+        return scenario.store[infoType]
+    delays = {}
+    for gtId in scenario.attachments:
+        delays[gtId] = []
+        for epoch in range(scenario.constellation.SIM_PERIOD):
+            satId = scenario.attachments[gtId][epoch]
+            if satId == None:
+                delays[gtId].append(0)
+                continue
+            dist = scenario.constellation.satDict[satId].sat-scenario.gtDict[gtId]
+            delays[gtId].append(getDelay(dist.at(scenario.constellation.PERIOD[epoch]).distance().km))
+    scenario.store[infoType] = delays
+    return delays
+
+def storeUserLinkDelays(scenario, dir):
+    print('Storing user link delays...')
+    gtIds = list(scenario.attachments.keys())
+    delays = getUserLinkDelays(scenario)
+    content = [','.join(['Time'] + gtIds) + '\n']
+    for epoch in range(scenario.constellation.SIM_PERIOD):
+        line = ','.join([str(epoch)] + [str(delays[gtId][epoch]) for gtId in gtIds])
+        line += '\n'
+        content.append(line)
+    delaysFile = open('%suserLinkDelays.csv'%(dir), 'w')
+    delaysFile.writelines(content)
+    delaysFile.close()
+
 def storeAttachments(scenario, dir):
     print('Storing attachments...')
     for gtId in scenario.attachments:
@@ -701,13 +755,97 @@ def storeGtPairs(scenario, dir, gtPairs):
     gtPairFile.writelines(gtPairContent)
     gtPairFile.close()
 
-def genNdnSIM(scenario, gtPairs):
+# binary scenario file read by ndn::sat::ScenarioFile, see extensions/sat/scenario-file.hpp for the layout
+SCENARIO_MAGIC = 0x534f454c # 'LEOS'
+SCENARIO_VERSION = 1
+
+def packU32(values):
+    return struct.pack('<%dI'%len(values), *values)
+
+def packI32(values):
+    return struct.pack('<%di'%len(values), *values)
+
+# store nodes, ISLs, link delays, attachments and pair routes in a single binary file, nodes are referred to by index
+def storeBinary(scenario, dir, gtPairs):
+    global SCENARIO_MAGIC
+    global SCENARIO_VERSION
+    print('Storing binary scenario...')
+    satIds = list(scenario.constellation.satDict.keys())
+    gtIds = list(scenario.gtDict.keys())
+    nodeIds = satIds + gtIds
+    nodeIdx = {nodeId: idx for idx, nodeId in enumerate(nodeIds)}
+
+    names = b''
+    nameOffsets = [0]
+    for nodeId in nodeIds:
+        names += nodeId.encode('utf-8')
+        nameOffsets.append(len(names))
+    nameBytes = len(names)
+    names += b'\0'*((4-nameBytes%4)%4) # keep the following arrays aligned
+
+    edges = list(scenario.constellation.snapshots[0].edges)
+    isls = []
+    for edge in edges:
+        isls += [nodeIdx[edge[0]], nodeIdx[edge[1]]]
+    islEpochs = list(range(len(scenario.constellation.snapshots)))
+    islDelays = []
+    for epoch in islEpochs:
+        G = scenario.constellation.snapshots[epoch]
+        islDelays += [getDelay(G[edge[0]][edge[1]]['weight']) for edge in edges]
+
+    userDelays = getUserLinkDelays(scenario)
+    userLinkDelays = []
+    for gtId in gtIds:
+        userLinkDelays += userDelays[gtId]
+
+    attOffsets = [0]
+    attachments = []
+    for gtId in gtIds:
+        gtAttachments = scenario.attachments[gtId]
+        for epoch in range(len(gtAttachments)):
+            if epoch != 0 and gtAttachments[epoch] == gtAttachments[epoch-1]:
+                continue
+            satIdx = -1 if gtAttachments[epoch] == None else nodeIdx[gtAttachments[epoch]]
+            attachments += [epoch, satIdx]
+        attOffsets.append(len(attachments)//2)
+
+    pairs = []
+    routeOffsets = [0]
+    routeTimes = []
+    hopOffsets = [0]
+    hops = []
+    for gtPair in gtPairs:
+        pairs += [nodeIdx[gtPair[0]], nodeIdx[gtPair[1]]]
+        route = scenario.getPairRoutes()[gtPair]
+        for epoch in route:
+            routeTimes.append(epoch)
+            hops += [nodeIdx[satId] for satId in route[epoch]]
+            hopOffsets.append(len(hops))
+        routeOffsets.append(len(routeTimes))
+
+    header = packU32([SCENARIO_MAGIC, SCENARIO_VERSION,
+                      len(satIds), len(gtIds), len(edges), len(islEpochs), scenario.constellation.SIM_PERIOD,
+                      len(gtPairs), len(attachments)//2, len(routeTimes), len(hops), nameBytes])
+    content = [header,
+               packU32(nameOffsets), names,
+               packU32(isls), packI32(islEpochs), packU32(islDelays), packU32(userLinkDelays),
+               packU32(attOffsets), packI32(attachments),
+               packU32(pairs), packU32(routeOffsets), packI32(routeTimes), packU32(hopOffsets), packU32(hops)]
+    binFile = open('%sscenario.bin'%(dir), 'wb')
+    binFile.writelines(content)
+    binFile.close()
+
+def genNdnSIM(scenario, gtPairs, binary=True):
     global NDNSIM_DIR
     print('Generating ndnSIM files...')
     storeNodes(scenario, NDNSIM_DIR)
     storeISLs(scenario, NDNSIM_DIR)
+    storeISLDelays(scenario, NDNSIM_DIR)
     storeAttachments(scenario, NDNSIM_DIR)
+    storeUserLinkDelays(scenario, NDNSIM_DIR)
     storeGtPairs(scenario, NDNSIM_DIR, gtPairs)
+    if binary:
+        storeBinary(scenario, NDNSIM_DIR, gtPairs)
     print('Done!')
 
 # # store global routes for a GT (slows down simulation)
@@ -112,7 +112,7 @@ Forwarder::onIncomingInterest(Face& inFace, const Interest& interest)
   }
 
   // detect duplicate Nonce with Dead Nonce List
-  bool hasDuplicateNonceInDnl = m_deadNonceList.has(interest.getName(), interest.getNonce());
+  bool hasDuplicateNonceInDnl = m_deadNonceList.has(interest, interest.getNonce());
   if (hasDuplicateNonceInDnl) {
     // goto Interest loop pipeline
     this->onInterestLoop(inFace, interest);
@@ -700,14 +700,14 @@ Forwarder::insertDeadNonceList(pit::Entry& pitEntry, Face* upstream)
     // insert all outgoing Nonces
     const auto& outRecords = pitEntry.getOutRecords();
     std::for_each(outRecords.begin(), outRecords.end(), [&] (const auto& outRecord) {
-      m_deadNonceList.add(pitEntry.getName(), outRecord.getLastNonce());
+      m_deadNonceList.add(pitEntry.getInterest(), outRecord.getLastNonce());
     });
   }
   else {
     // insert outgoing Nonce of a specific face
     auto outRecord = pitEntry.getOutRecord(*upstream);
     if (outRecord != pitEntry.getOutRecords().end()) {
-      m_deadNonceList.add(pitEntry.getName(), outRecord->getLastNonce());
+      m_deadNonceList.add(pitEntry.getInterest(), outRecord->getLastNonce());
     }
   }
 }
@@ -26,6 +26,7 @@
 #include "cs.hpp"
 #include "core/algorithm.hpp"
 #include "core/logger.hpp"
+#include "core/scope-prefix.hpp"
 
 #include <ndn-cxx/lp/tags.hpp>
 #include <ndn-cxx/util/concepts.hpp>
@@ -59,7 +60,7 @@ Cs::insert(const Data& data, bool isUnsolicited)
   }
   NFD_LOG_DEBUG("insert " << data.getName());
 
-  if (Name("/localhost").isPrefixOf(data.getName())) {
+  if (scope_prefix::LOCALHOST.isPrefixOf(data.getName())) {
     return;
   }
 
@@ -88,6 +89,7 @@ Cs::insert(const Data& data, bool isUnsolicited)
     m_policy->afterRefresh(it);
   }
   else {
+    this->indexEntry(it);
     m_policy->afterInsert(it);
   }
 }
@@ -106,7 +108,7 @@ Cs::erase(const Name& prefix, size_t limit, const AfterEraseCallback& cb)
   size_t nErased = 0;
   while (first != last && nErased < limit) {
     m_policy->beforeErase(first);
-    first = m_table.erase(first);
+    first = this->eraseEntry(first);
     ++nErased;
   }
 
@@ -131,21 +133,31 @@ Cs::find(const Interest& interest,
   bool isRightmost = interest.getChildSelector() == 1;
   NFD_LOG_DEBUG("find " << prefix << (isRightmost ? " R" : " L"));
 
-  iterator first = m_table.lower_bound(prefix);
-  iterator last = m_table.end();
-  if (prefix.size() > 0) {
-    last = m_table.lower_bound(prefix.getSuccessor());
-  }
-
-  iterator match = last;
-  if (isRightmost) {
-    match = this->findRightmost(interest, first, last);
+  iterator match = m_table.end();
+  if (!interest.getCanBePrefix() && (prefix.empty() || !prefix[-1].isImplicitSha256Digest())) {
+    // only Data with exactly the Interest Name can match
+    match = this->findExact(interest, isRightmost);
   }
   else {
-    match = this->findLeftmost(interest, first, last);
+    iterator first = m_table.lower_bound(prefix);
+    iterator last = m_table.end();
+    if (prefix.size() > 0) {
+      last = m_table.lower_bound(prefix.getSuccessor());
+    }
+
+    if (isRightmost) {
+      match = this->findRightmost(interest, first, last);
+    }
+    else {
+      match = this->findLeftmost(interest, first, last);
+    }
+
+    if (match == last) {
+      match = m_table.end();
+    }
   }
 
-  if (match == last) {
+  if (match == m_table.end()) {
     NFD_LOG_DEBUG("  no-match");
     missCallback(interest);
     return;
@@ -199,6 +211,45 @@ Cs::findRightmostAmongExact(const Interest& interest, iterator first, iterator l
   return find_last_if(first, last, [&interest] (const auto& entry) { return entry.canSatisfy(interest); });
 }
 
+iterator
+Cs::findExact(const Interest& interest, bool isRightmost) const
+{
+  const Name& name = interest.getName();
+  iterator match = m_table.end();
+
+  auto range = m_exactIndex.equal_range(name_tree::getHashes(interest).back());
+  for (auto i = range.first; i != range.second; ++i) {
+    iterator it = i->second;
+    if (it->getName() != name || !it->canSatisfy(interest)) {
+      continue;
+    }
+    // entries with the same Name differ in implicit digest, keep the order of the Table
+    if (match == m_table.end() || (isRightmost ? *match < *it : *it < *match)) {
+      match = it;
+    }
+  }
+  return match;
+}
+
+void
+Cs::indexEntry(iterator it)
+{
+  m_exactIndex.emplace(name_tree::getHashes(it->getData()).back(), it);
+}
+
+iterator
+Cs::eraseEntry(iterator it)
+{
+  auto range = m_exactIndex.equal_range(name_tree::getHashes(it->getData()).back());
+  for (auto i = range.first; i != range.second; ++i) {
+    if (i->second == it) {
+      m_exactIndex.erase(i);
+      break;
+    }
+  }
+  return m_table.erase(it);
+}
+
 void
 Cs::dump()
 {
@@ -224,7 +275,7 @@ Cs::setPolicyImpl(unique_ptr<Policy> policy)
   NFD_LOG_DEBUG("set-policy " << policy->getName());
   m_policy = std::move(policy);
   m_beforeEvictConnection = m_policy->beforeEvict.connect([this] (iterator it) {
-      m_table.erase(it);
+      this->eraseEntry(it);
     });
 
   m_policy->setCs(this);
@@ -29,8 +29,10 @@
 #include "cs-policy.hpp"
 #include "cs-internal.hpp"
 #include "cs-entry-impl.hpp"
+#include "name-tree-hashtable.hpp"
 #include <ndn-cxx/util/signal.hpp>
 #include <boost/iterator/transform_iterator.hpp>
+#include <unordered_map>
 
 namespace nfd {
 namespace cs {
@@ -44,6 +46,10 @@ namespace cs {
  *  and a few additional attributes such as when the Data becomes non-fresh.
  *
  *  The replacement policy is implemented in a subclass of \c Policy.
+ *
+ *  Entries are also indexed by the hash of their Names, so that Interests that cannot be
+ *  satisfied by Data with longer Names (CanBePrefix=false) are looked up without walking
+ *  the Table.
  */
 class Cs : noncopyable
 {
@@ -198,6 +204,22 @@ private: // find
   iterator
   findRightmostAmongExact(const Interest& interest, iterator first, iterator last) const;
 
+  /** \brief find match among entries whose Names equal the Interest Name, using the hash index
+   *  \return the leftmost or rightmost match, in Table order, or m_table.end() if not found
+   */
+  iterator
+  findExact(const Interest& interest, bool isRightmost) const;
+
+private: // hash index
+  void
+  indexEntry(iterator it);
+
+  /** \brief erase an entry from the Table and the hash index
+   *  \return iterator following the erased entry
+   */
+  iterator
+  eraseEntry(iterator it);
+
   void
   setPolicyImpl(unique_ptr<Policy> policy);
 
@@ -207,6 +229,7 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE:
 
 private:
   Table m_table;
+  std::unordered_multimap<name_tree::HashValue, iterator> m_exactIndex; ///< Name hash => entry
   unique_ptr<Policy> m_policy;
   signal::ScopedConnection m_beforeEvictConnection;
 
@@ -24,6 +24,7 @@
  */
 
 #include "dead-nonce-list.hpp"
+#include "name-tree-hashtable.hpp"
 #include "core/city-hash.hpp"
 #include "core/logger.hpp"
 
@@ -49,6 +50,7 @@ DeadNonceList::DeadNonceList(const time::nanoseconds& lifetime)
   , m_capacity(INITIAL_CAPACITY)
   , m_markInterval(m_lifetime / EXPECTED_MARK_COUNT)
   , m_adjustCapacityInterval(m_lifetime)
+  , m_isParked(true)
 {
   if (m_lifetime < MIN_LIFETIME) {
     BOOST_THROW_EXCEPTION(std::invalid_argument("lifetime is less than MIN_LIFETIME"));
@@ -58,8 +60,10 @@ DeadNonceList::DeadNonceList(const time::nanoseconds& lifetime)
     m_queue.push_back(MARK);
   }
 
-  m_markEvent = scheduler::schedule(m_markInterval, [this] { mark(); });
-  m_adjustCapacityEvent = scheduler::schedule(m_adjustCapacityInterval, [this] { adjustCapacity(); });
+  // the index holds no Nonce yet, timers are armed by the first add()
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  m_nextMark = now + m_markInterval;
+  m_nextAdjustCapacity = now + m_adjustCapacityInterval;
 }
 
 DeadNonceList::~DeadNonceList()
@@ -88,25 +92,49 @@ DeadNonceList::size() const
 bool
 DeadNonceList::has(const Name& name, uint32_t nonce) const
 {
-  Entry entry = DeadNonceList::makeEntry(name, nonce);
+  Entry entry = DeadNonceList::makeEntry(name_tree::computeHashes(name), nonce);
+  return m_ht.find(entry) != m_ht.end();
+}
+
+bool
+DeadNonceList::has(const Interest& interest, uint32_t nonce) const
+{
+  Entry entry = DeadNonceList::makeEntry(name_tree::getHashes(interest), nonce);
   return m_ht.find(entry) != m_ht.end();
 }
 
 void
 DeadNonceList::add(const Name& name, uint32_t nonce)
 {
-  Entry entry = DeadNonceList::makeEntry(name, nonce);
+  this->addEntry(DeadNonceList::makeEntry(name_tree::computeHashes(name), nonce));
+}
+
+void
+DeadNonceList::add(const Interest& interest, uint32_t nonce)
+{
+  this->addEntry(DeadNonceList::makeEntry(name_tree::getHashes(interest), nonce));
+}
+
+void
+DeadNonceList::addEntry(Entry entry)
+{
+  this->resume();
   m_queue.push_back(entry);
 
   this->evictEntries();
 }
 
 DeadNonceList::Entry
-DeadNonceList::makeEntry(const Name& name, uint32_t nonce)
+DeadNonceList::makeEntry(const name_tree::HashSequence& hashes, uint32_t nonce)
 {
-  Block nameWire = name.wireEncode();
-  return CityHash64WithSeed(reinterpret_cast<const char*>(nameWire.wire()), nameWire.size(),
-                            static_cast<uint64_t>(nonce));
+  // A NameTree hash XORs the component hashes, so reordered or repeated components cancel out
+  // (/a/b/b/c and /a/d/d/c have the same hash). Chaining the hashes of all prefixes, from which
+  // the component hashes are recovered, makes the entry depend on each component in order.
+  uint64_t h = nonce;
+  for (size_t i = 1; i < hashes.size(); ++i) {
+    h = Hash128to64(uint128(h, static_cast<uint64_t>(hashes[i])));
+  }
+  return h;
 }
 
 size_t
@@ -123,8 +151,6 @@ DeadNonceList::mark()
   m_actualMarkCounts.insert(nMarks);
 
   NFD_LOG_TRACE("mark nMarks=" << nMarks);
-
-  m_markEvent = scheduler::schedule(m_markInterval, [this] { mark(); });
 }
 
 void
@@ -146,8 +172,74 @@ DeadNonceList::adjustCapacity()
 
   m_actualMarkCounts.clear();
   this->evictEntries();
+}
+
+void
+DeadNonceList::onMarkTimer()
+{
+  this->mark();
+  m_nextMark += m_markInterval;
+
+  if (!this->parkIfIdle()) {
+    m_markEvent = scheduler::schedule(m_markInterval, [this] { onMarkTimer(); });
+  }
+}
+
+void
+DeadNonceList::onAdjustCapacityTimer()
+{
+  this->adjustCapacity();
+  m_nextAdjustCapacity += m_adjustCapacityInterval;
+
+  if (!this->parkIfIdle()) {
+    m_adjustCapacityEvent = scheduler::schedule(m_adjustCapacityInterval,
+                                                [this] { onAdjustCapacityTimer(); });
+  }
+}
+
+bool
+DeadNonceList::parkIfIdle()
+{
+  if (this->size() > 0) {
+    return false;
+  }
+
+  scheduler::cancel(m_markEvent);
+  scheduler::cancel(m_adjustCapacityEvent);
+  m_isParked = true;
+  NFD_LOG_TRACE("park capacity=" << m_capacity);
+  return true;
+}
+
+void
+DeadNonceList::resume()
+{
+  if (!m_isParked) {
+    return;
+  }
+  m_isParked = false;
+
+  // Replay the missed timers in the order the scheduler would have run them.
+  // On a tie, the adjustCapacity timer was armed one lifetime earlier than the mark timer.
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  size_t nReplayed = 0;
+  while (m_nextMark <= now || m_nextAdjustCapacity <= now) {
+    if (m_nextAdjustCapacity <= m_nextMark) {
+      this->adjustCapacity();
+      m_nextAdjustCapacity += m_adjustCapacityInterval;
+    }
+    else {
+      this->mark();
+      m_nextMark += m_markInterval;
+    }
+    ++nReplayed;
+  }
+  NFD_LOG_TRACE("resume nReplayed=" << nReplayed << " capacity=" << m_capacity);
 
-  m_adjustCapacityEvent = scheduler::schedule(m_adjustCapacityInterval, [this] { adjustCapacity(); });
+  // arm adjustCapacity first, so that it still runs first on a tie
+  m_adjustCapacityEvent = scheduler::schedule(m_nextAdjustCapacity - now,
+                                              [this] { onAdjustCapacityTimer(); });
+  m_markEvent = scheduler::schedule(m_nextMark - now, [this] { onMarkTimer(); });
 }
 
 void
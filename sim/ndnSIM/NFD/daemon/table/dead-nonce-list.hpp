@@ -27,6 +27,7 @@
 #define NFD_DAEMON_TABLE_DEAD_NONCE_LIST_HPP
 
 #include "core/common.hpp"
+#include "name-tree-hashtable.hpp"
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/hashed_index.hpp>
@@ -40,16 +41,21 @@ namespace nfd {
  *  When a Nonce is erased (dead) from PIT entry, the Nonce and the Interest Name is added to
  *  Dead Nonce List, and kept for a duration in which most loops are expected to have occured.
  *
- *  To reduce memory usage, the Interest Name and Nonce are stored as a 64-bit hash.
- *  There could be false positives (non-looping Interest could be considered looping),
- *  but the probability is small, and the error is recoverable when consumer retransmits
- *  with a different Nonce.
+ *  To reduce memory usage, the Interest Name and Nonce are stored as a 64-bit hash,
+ *  derived from the NameTree hash of the Name, so that it can reuse the Name hashes cached
+ *  on the Interest. There could be false positives (non-looping Interest could be considered
+ *  looping), but the probability is small, and the error is recoverable when consumer
+ *  retransmits with a different Nonce.
  *
  *  To reduce memory usage, entries do not have associated timestamps. Instead,
  *  lifetime of entries is controlled by dynamically adjusting the capacity of the container.
  *  At fixed intervals, the MARK, an entry with a special value, is inserted into the container.
  *  The number of MARKs stored in the container reflects the lifetime of entries,
  *  because MARKs are inserted at fixed intervals.
+ *
+ *  The timers inserting MARKs and adjusting capacity are parked while no Nonce is stored,
+ *  and the missed runs are replayed when the next Nonce is added, so that idle forwarders
+ *  do not keep the simulator busy.
  */
 class DeadNonceList : noncopyable
 {
@@ -72,11 +78,23 @@ public:
   bool
   has(const Name& name, uint32_t nonce) const;
 
+  /** \brief determines if interest.getName()+nonce exists
+   *  \note This overload uses the Name hashes cached on \p interest.
+   */
+  bool
+  has(const Interest& interest, uint32_t nonce) const;
+
   /** \brief records name+nonce
    */
   void
   add(const Name& name, uint32_t nonce);
 
+  /** \brief records interest.getName()+nonce
+   *  \note This overload uses the Name hashes cached on \p interest.
+   */
+  void
+  add(const Interest& interest, uint32_t nonce);
+
   /** \return number of stored Nonces
    *  \note The return value does not contain non-Nonce entries in the index, if any.
    */
@@ -91,8 +109,13 @@ public:
 private: // Entry and Index
   typedef uint64_t Entry;
 
+  /** \param hashes hashes of each prefix of the Name, as computed by name_tree::computeHashes
+   */
   static Entry
-  makeEntry(const Name& name, uint32_t nonce);
+  makeEntry(const name_tree::HashSequence& hashes, uint32_t nonce);
+
+  void
+  addEntry(Entry entry);
 
   typedef boost::multi_index_container<
     Entry,
@@ -131,6 +154,34 @@ private: // actual lifetime estimation and capacity control
   void
   evictEntries();
 
+private: // quiescence
+  /** \brief calls mark(), then re-arms its timer unless the timers are parked
+   */
+  void
+  onMarkTimer();
+
+  /** \brief calls adjustCapacity(), then re-arms its timer unless the timers are parked
+   */
+  void
+  onAdjustCapacityTimer();
+
+  /** \brief parks the timers if the index holds no Nonce
+   *  \return whether the timers are parked
+   *
+   *  While only MARKs are stored, has() and size() do not depend on the MARKs and capacity,
+   *  so the timers need not run until the next Nonce is added.
+   */
+  bool
+  parkIfIdle();
+
+  /** \brief runs the parked mark() and adjustCapacity() that were due, and re-arms the timers
+   *
+   *  mark() and adjustCapacity() only depend on the content of the index, which does not change
+   *  while parked, so the index and capacity end up as if the timers had kept running.
+   */
+  void
+  resume();
+
 public:
   /// default entry lifetime
   static const time::nanoseconds DEFAULT_LIFETIME;
@@ -206,6 +257,20 @@ PUBLIC_WITH_TESTS_ELSE_PRIVATE: // actual lifetime estimation and capacity contr
 
   scheduler::EventId m_adjustCapacityEvent;
 
+  // ---- quiescence
+
+  /** \brief whether the timers are parked, see parkIfIdle()
+   */
+  bool m_isParked;
+
+  /** \brief when the mark timer is due, kept while parked
+   */
+  time::steady_clock::TimePoint m_nextMark;
+
+  /** \brief when the adjustCapacity timer is due, kept while parked
+   */
+  time::steady_clock::TimePoint m_nextAdjustCapacity;
+
   /** \brief maximum number of entries to evict at each operation if index is over capacity
    */
   static const size_t EVICT_LIMIT;
@@ -89,15 +89,16 @@ Measurements::getParent(const Entry& child)
   return &this->get(*nte);
 }
 
-template<typename K>
 Entry*
-Measurements::findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pred) const
+Measurements::findLongestPrefixMatchImpl(const Name& name, const name_tree::HashSequence& hashes,
+                                         const EntryPredicate& pred) const
 {
-  name_tree::Entry* match = m_nameTree.findLongestPrefixMatch(key,
+  name_tree::Entry* match = m_nameTree.findLongestPrefixMatch(name,
     [&pred] (const name_tree::Entry& nte) {
       const Entry* entry = nte.getMeasurementsEntry();
       return entry != nullptr && pred(*entry);
-    });
+    },
+    hashes);
   if (match != nullptr) {
     return match->getMeasurementsEntry();
   }
@@ -107,13 +108,15 @@ Measurements::findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pre
 Entry*
 Measurements::findLongestPrefixMatch(const Name& name, const EntryPredicate& pred) const
 {
-  return this->findLongestPrefixMatchImpl(name.getPrefix(NameTree::getMaxDepth()), pred);
+  size_t depth = std::min(name.size(), getMaxDepth());
+  return this->findLongestPrefixMatchImpl(name, name_tree::computeHashes(name, depth), pred);
 }
 
 Entry*
 Measurements::findLongestPrefixMatch(const pit::Entry& pitEntry, const EntryPredicate& pred) const
 {
-  return this->findLongestPrefixMatch(pitEntry.getName(), pred);
+  return this->findLongestPrefixMatchImpl(pitEntry.getName(),
+                                          name_tree::getHashes(pitEntry.getInterest()), pred);
 }
 
 Entry*
@@ -153,11 +153,11 @@ private:
   Entry&
   get(name_tree::Entry& nte);
 
-  /** \tparam K a parameter acceptable to \c NameTree::findLongestPrefixMatch
+  /** \pre hashes[i] == name_tree::computeHash(name, i) for every i <= min(name.size(), getMaxDepth())
    */
-  template<typename K>
   Entry*
-  findLongestPrefixMatchImpl(const K& key, const EntryPredicate& pred) const;
+  findLongestPrefixMatchImpl(const Name& name, const name_tree::HashSequence& hashes,
+                             const EntryPredicate& pred) const;
 
 private:
   NameTree& m_nameTree;
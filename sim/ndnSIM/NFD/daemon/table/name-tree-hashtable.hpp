@@ -53,6 +53,25 @@ computeHash(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::ma
 HashSequence
 computeHashes(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::max());
 
+/** \brief returns hash values for each prefix of \p packet.getName()
+ *  \tparam Packet \c Interest or \c Data
+ *  \return the packet's Name hash cache, filled with computeHashes(packet.getName()) if empty
+ *
+ *  The hashes are computed once per packet, and reused by every table that looks up the packet
+ *  or a copy of it, such as the Interest stored in a PIT entry.
+ */
+template<typename Packet>
+const HashSequence&
+getHashes(const Packet& packet)
+{
+  HashSequence& hashes = packet.getNameHashCache();
+  if (hashes.empty()) {
+    hashes = computeHashes(packet.getName());
+  }
+  BOOST_ASSERT(hashes.size() == packet.getName().size() + 1);
+  return hashes;
+}
+
 /** \brief a hashtable node
  *
  *  Zero or more nodes can be added to a hashtable bucket. They are organized as
@@ -94,6 +94,12 @@ public: // mutation
   Entry&
   lookup(const Name& name, size_t prefixLen);
 
+  /** \brief equivalent to `lookup(name, prefixLen)`, using precomputed hashes
+   *  \pre hashes[i] == computeHash(name, i) for every i <= prefixLen
+   */
+  Entry&
+  lookup(const Name& name, size_t prefixLen, const HashSequence& hashes);
+
   /** \brief equivalent to `lookup(name, name.size())`
    */
   Entry&
@@ -151,6 +157,12 @@ public: // matching
   Entry*
   findExactMatch(const Name& name, size_t prefixLen = std::numeric_limits<size_t>::max()) const;
 
+  /** \brief equivalent to `findExactMatch(name, prefixLen)`, using precomputed hashes
+   *  \pre hashes == computeHashes(name)
+   */
+  Entry*
+  findExactMatch(const Name& name, size_t prefixLen, const HashSequence& hashes) const;
+
   /** \brief longest prefix matching
    *  \return entry whose name is a prefix of \p name and passes \p entrySelector,
    *          where no other entry with a longer name satisfies those requirements;
@@ -160,6 +172,13 @@ public: // matching
   findLongestPrefixMatch(const Name& name,
                          const EntrySelector& entrySelector = AnyEntry()) const;
 
+  /** \brief equivalent to `findLongestPrefixMatch(name, entrySelector)`, using precomputed hashes
+   *  \pre hashes[i] == computeHash(name, i) for every i <= min(name.size(), getMaxDepth())
+   */
+  Entry*
+  findLongestPrefixMatch(const Name& name, const EntrySelector& entrySelector,
+                         const HashSequence& hashes) const;
+
   /** \brief equivalent to `findLongestPrefixMatch(entry.getName(), entrySelector)`
    *  \note This overload is more efficient than
    *        `findLongestPrefixMatch(const Name&, const EntrySelector&)` in common cases.
@@ -216,6 +235,13 @@ public: // matching
   findAllMatches(const Name& name,
                  const EntrySelector& entrySelector = AnyEntry()) const;
 
+  /** \brief equivalent to `findAllMatches(name, entrySelector)`, using precomputed hashes
+   *  \pre hashes[i] == computeHash(name, i) for every i <= min(name.size(), getMaxDepth())
+   */
+  Range
+  findAllMatches(const Name& name, const EntrySelector& entrySelector,
+                 const HashSequence& hashes) const;
+
 public: // enumeration
   using const_iterator = Iterator;
 
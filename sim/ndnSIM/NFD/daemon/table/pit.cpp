@@ -52,10 +52,10 @@ Pit::findOrInsert(const Interest& interest, bool allowInsert)
   // ensure NameTree entry exists
   name_tree::Entry* nte = nullptr;
   if (allowInsert) {
-    nte = &m_nameTree.lookup(name, nteDepth);
+    nte = &m_nameTree.lookup(name, nteDepth, name_tree::getHashes(interest));
   }
   else {
-    nte = m_nameTree.findExactMatch(name, nteDepth);
+    nte = m_nameTree.findExactMatch(name, nteDepth, name_tree::getHashes(interest));
     if (nte == nullptr) {
       return {nullptr, true};
     }
@@ -86,7 +86,8 @@ Pit::findOrInsert(const Interest& interest, bool allowInsert)
 DataMatchResult
 Pit::findAllDataMatches(const Data& data) const
 {
-  auto&& ntMatches = m_nameTree.findAllMatches(data.getName(), &nteHasPitEntries);
+  auto&& ntMatches = m_nameTree.findAllMatches(data.getName(), &nteHasPitEntries,
+                                               name_tree::getHashes(data));
 
   DataMatchResult matches;
   for (const name_tree::Entry& nte : ntMatches) {
@@ -21,13 +21,17 @@
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
 #include "model/ndn-l3-protocol.hpp"
 #include "helper/ndn-fib-helper.hpp"
 
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+
 #include <memory>
+#include <map>
 
 NS_LOG_COMPONENT_DEFINE("ndn.Producer");
 
@@ -63,7 +67,12 @@ Producer::GetTypeId(void)
          MakeUintegerChecker<uint32_t>())
       .AddAttribute("KeyLocator",
                     "Name to be used for key locator.  If root, then key locator is not used",
-                    NameValue(), MakeNameAccessor(&Producer::m_keyLocator), MakeNameChecker());
+                    NameValue(), MakeNameAccessor(&Producer::m_keyLocator), MakeNameChecker())
+      .AddAttribute("ReuseEncoding",
+                    "Encode Content and signature once at start and only encode Name and MetaInfo "
+                    "of each Data, the wire format is unchanged",
+                    BooleanValue(false), MakeBooleanAccessor(&Producer::m_reuseEncoding),
+                    MakeBooleanChecker());
   return tid;
 }
 
@@ -72,6 +81,18 @@ Producer::Producer()
   NS_LOG_FUNCTION_NOARGS();
 }
 
+::ndn::ConstBufferPtr
+Producer::GetPayload(uint32_t size)
+{
+  static std::map<uint32_t, ::ndn::ConstBufferPtr> payloads;
+
+  auto& payload = payloads[size];
+  if (payload == nullptr) {
+    payload = make_shared<::ndn::Buffer>(size);
+  }
+  return payload;
+}
+
 // inherited from Application base class.
 void
 Producer::StartApplication()
@@ -80,6 +101,18 @@ Producer::StartApplication()
   App::StartApplication();
 
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
+
+  m_encodedTail = nullptr;
+  if (m_reuseEncoding) {
+    Data data;
+    SetContentAndSignature(data);
+
+    ::ndn::EncodingBuffer encoder;
+    encoder.prependBlock(data.getSignature().getValue());
+    encoder.prependBlock(data.getSignature().getInfo());
+    encoder.prependBlock(data.getContent());
+    m_encodedTail = make_shared<::ndn::Buffer>(encoder.buf(), encoder.size());
+  }
 }
 
 void
@@ -108,7 +141,25 @@ Producer::OnInterest(shared_ptr<const Interest> interest)
   data->setName(dataName);
   data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
 
-  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
+  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
+
+  // to create real wire encoding
+  if (m_encodedTail != nullptr) {
+    EncodeWithTail(*data);
+  }
+  else {
+    SetContentAndSignature(*data);
+    data->wireEncode();
+  }
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+void
+Producer::SetContentAndSignature(Data& data) const
+{
+  data.setContent(GetPayload(m_virtualPayloadSize));
 
   Signature signature;
   SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
@@ -120,15 +171,27 @@ Producer::OnInterest(shared_ptr<const Interest> interest)
   signature.setInfo(signatureInfo);
   signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
 
-  data->setSignature(signature);
-
-  NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
-
-  // to create real wire encoding
-  data->wireEncode();
+  data.setSignature(signature);
+}
 
-  m_transmittedDatas(data, this, m_face);
-  m_appLink->onReceiveData(*data);
+void
+Producer::EncodeWithTail(Data& data) const
+{
+  // same order as Data::wireEncode, the buffer is allocated once with the exact size
+  ::ndn::EncodingEstimator estimator;
+  size_t length = data.getMetaInfo().wireEncode(estimator) + data.getName().wireEncode(estimator)
+                  + m_encodedTail->size();
+
+  ::ndn::EncodingBuffer encoder(::ndn::tlv::sizeOfVarNumber(::ndn::tlv::Data)
+                                + ::ndn::tlv::sizeOfVarNumber(length) + length, 0);
+  encoder.prependByteArray(m_encodedTail->data(), m_encodedTail->size());
+  data.getMetaInfo().wireEncode(encoder);
+  data.getName().wireEncode(encoder);
+  encoder.prependVarNumber(length);
+  encoder.prependVarNumber(::ndn::tlv::Data);
+
+  // sets content and signature as views of the wire
+  data.wireDecode(encoder.block());
 }
 
 } // namespace ndn
@@ -51,6 +51,12 @@ public:
   virtual void
   OnInterest(shared_ptr<const Interest> interest);
 
+  /**
+   * @brief Get the zero-filled payload of the given size, shared by all producers
+   */
+  static ::ndn::ConstBufferPtr
+  GetPayload(uint32_t size);
+
 protected:
   // inherited from Application base class.
   virtual void
@@ -59,6 +65,21 @@ protected:
   virtual void
   StopApplication(); // Called at time specified by Stop
 
+private:
+  /**
+   * @brief Set content and fake signature of data
+   */
+  void
+  SetContentAndSignature(Data& data) const;
+
+  /**
+   * @brief Encode data prepending its name and MetaInfo to the encoded tail
+   *
+   * The wire format is the same as with Data::wireEncode.
+   */
+  void
+  EncodeWithTail(Data& data) const;
+
 private:
   Name m_prefix;
   Name m_postfix;
@@ -67,6 +88,9 @@ private:
 
   uint32_t m_signature;
   Name m_keyLocator;
+
+  bool m_reuseEncoding;
+  ::ndn::ConstBufferPtr m_encodedTail; ///< @brief Content, SignatureInfo and SignatureValue elements
 };
 
 } // namespace ndn
@@ -39,6 +39,8 @@
 #include "ns3/data-rate.h"
 
 #include "daemon/mgmt/fib-manager.hpp"
+#include "daemon/fw/forwarder.hpp"
+#include "daemon/table/fib.hpp"
 #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
 
@@ -253,6 +255,127 @@ FibHelper::RemoveRoute(const std::string& nodeName, const Name& prefix,
   RemoveRoute(node, prefix, otherNode);
 }
 
+static shared_ptr<Face>
+getPointToPointFace(Ptr<Node> node, Ptr<Node> otherNode)
+{
+  for (uint32_t deviceId = 0; deviceId < node->GetNDevices(); deviceId++) {
+    Ptr<PointToPointNetDevice> netDevice =
+      DynamicCast<PointToPointNetDevice>(node->GetDevice(deviceId));
+    if (netDevice == 0)
+      continue;
+
+    Ptr<Channel> channel = netDevice->GetChannel();
+    if (channel == 0)
+      continue;
+
+    if (channel->GetDevice(0)->GetNode() == otherNode
+        || channel->GetDevice(1)->GetNode() == otherNode) {
+      Ptr<L3Protocol> ndn = node->GetObject<L3Protocol>();
+      NS_ASSERT_MSG(ndn != 0, "Ndn stack should be installed on the node");
+
+      shared_ptr<Face> face = ndn->getFaceByNetDevice(netDevice);
+      NS_ASSERT_MSG(face != 0, "There is no face associated with the p2p link");
+      return face;
+    }
+  }
+
+  NS_FATAL_ERROR("Node# " << node->GetId() << " and Node# " << otherNode->GetId()
+                          << " are not connected");
+  return nullptr;
+}
+
+void
+FibUpdateTransaction::AddRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face,
+                               int32_t metric)
+{
+  NS_ASSERT_MSG(prefix.size() <= nfd::Fib::getMaxDepth(),
+                "FIB entry prefix cannot exceed " << nfd::Fib::getMaxDepth() << " components");
+  m_changes.push_back({node, prefix, face, metric, ADD});
+}
+
+void
+FibUpdateTransaction::AddRoute(Ptr<Node> node, const Name& prefix, Ptr<Node> otherNode,
+                               int32_t metric)
+{
+  AddRoute(node, prefix, getPointToPointFace(node, otherNode), metric);
+}
+
+void
+FibUpdateTransaction::ReplaceRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face,
+                                   int32_t metric)
+{
+  NS_ASSERT_MSG(prefix.size() <= nfd::Fib::getMaxDepth(),
+                "FIB entry prefix cannot exceed " << nfd::Fib::getMaxDepth() << " components");
+  m_changes.push_back({node, prefix, face, metric, REPLACE});
+}
+
+void
+FibUpdateTransaction::RemoveRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face)
+{
+  m_changes.push_back({node, prefix, face, 0, REMOVE});
+}
+
+void
+FibUpdateTransaction::RemoveRoute(Ptr<Node> node, const Name& prefix, Ptr<Node> otherNode)
+{
+  RemoveRoute(node, prefix, getPointToPointFace(node, otherNode));
+}
+
+void
+FibUpdateTransaction::Commit()
+{
+  // changes are usually grouped by node, so the FIB of the last node is kept at hand
+  Ptr<Node> node;
+  nfd::Fib* fib = nullptr;
+
+  for (const auto& change : m_changes) {
+    if (change.node != node) {
+      Ptr<L3Protocol> ndn = change.node->GetObject<L3Protocol>();
+      NS_ASSERT_MSG(ndn != 0, "Ndn stack should be installed on the node");
+      node = change.node;
+      fib = &ndn->getForwarder()->getFib();
+    }
+
+    if (change.face->getId() == nfd::face::INVALID_FACEID) {
+      NS_LOG_LOGIC("[" << node->GetId() << "]$ route " << (change.type == REMOVE ? "del " : "add ")
+                       << change.prefix << ": face is closed, skipped");
+      continue;
+    }
+
+    if (change.type == REMOVE) {
+      NS_LOG_LOGIC("[" << node->GetId() << "]$ route del " << change.prefix << " via "
+                       << change.face->getLocalUri());
+
+      nfd::fib::Entry* entry = fib->findExactMatch(change.prefix);
+      if (entry != nullptr) {
+        fib->removeNextHop(*entry, *change.face, 0);
+      }
+    }
+    else {
+      NS_LOG_LOGIC("[" << node->GetId() << "]$ route " << (change.type == REPLACE ? "replace " : "add ")
+                       << change.prefix << " via " << change.face->getLocalUri() << " metric " << change.metric);
+
+      nfd::fib::Entry* entry = fib->insert(change.prefix).first;
+      fib->addOrUpdateNextHop(*entry, *change.face, 0, change.metric);
+
+      if (change.type == REPLACE) {
+        // the entry keeps the new next hop, so it is not erased with the others
+        std::vector<const Face*> others;
+        for (const auto& nextHop : entry->getNextHops()) {
+          if (&nextHop.getFace() != change.face.get()) {
+            others.push_back(&nextHop.getFace());
+          }
+        }
+        for (const Face* other : others) {
+          fib->removeNextHopByFace(*entry, *other);
+        }
+      }
+    }
+  }
+
+  m_changes.clear();
+}
+
 } // namespace ndn
 
 } // namespace ns
@@ -28,6 +28,8 @@
 
 #include <ndn-cxx/mgmt/nfd/control-parameters.hpp>
 
+#include <vector>
+
 namespace ns3 {
 namespace ndn {
 
@@ -161,6 +163,108 @@ private:
   RemoveNextHop(const ControlParameters& parameters, Ptr<Node> node);
 };
 
+/**
+ * @ingroup ndn-helpers
+ * @brief Batch of FIB changes applied directly to the FIBs of one or more nodes
+ *
+ * Unlike FibHelper::AddRoute and FibHelper::RemoveRoute, which sign a command Interest and
+ * inject it into the FIB manager of the node, changes are recorded and later applied to nfd::Fib
+ * in place, in the order they were added, when Commit is called.  nfd::Fib still signals new next
+ * hops (afterNewNextHop), so forwarding strategies are notified as with the FIB manager.
+ *
+ * Changes towards faces that have been closed by the time of Commit are skipped.
+ */
+class FibUpdateTransaction {
+public:
+  /**
+   * \brief Add or update a next hop of the FIB entry of prefix
+   *
+   * \param node   Node
+   * \param prefix Routing prefix
+   * \param face   Face
+   * \param metric Routing metric
+   */
+  void
+  AddRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face, int32_t metric);
+
+  /**
+   * @brief Add or update a next hop of the FIB entry of prefix (work only with point-to-point links)
+   *
+   * \param node      Node
+   * \param prefix    Routing prefix
+   * \param otherNode The other node, to which interests will be forwarded
+   * \param metric    Routing metric
+   */
+  void
+  AddRoute(Ptr<Node> node, const Name& prefix, Ptr<Node> otherNode, int32_t metric);
+
+  /**
+   * \brief Make face the only next hop of the FIB entry of prefix
+   *
+   * The other next hops are removed when the change is applied, so that the last replacement of
+   * the transaction for the same prefix wins.
+   *
+   * \param node   Node
+   * \param prefix Routing prefix
+   * \param face   Face
+   * \param metric Routing metric
+   */
+  void
+  ReplaceRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face, int32_t metric);
+
+  /**
+   * \brief Remove a next hop of the FIB entry of prefix, the entry is erased with its last next hop
+   *
+   * \param node   Node
+   * \param prefix Routing prefix
+   * \param face   Face
+   */
+  void
+  RemoveRoute(Ptr<Node> node, const Name& prefix, shared_ptr<Face> face);
+
+  /**
+   * @brief Remove a next hop of the FIB entry of prefix (work only with point-to-point links)
+   *
+   * \param node      Node
+   * \param prefix    Routing prefix
+   * \param otherNode The other node, to which interests were forwarded
+   */
+  void
+  RemoveRoute(Ptr<Node> node, const Name& prefix, Ptr<Node> otherNode);
+
+  /**
+   * \brief Number of changes not committed yet
+   */
+  size_t
+  GetSize() const
+  {
+    return m_changes.size();
+  }
+
+  /**
+   * \brief Apply all recorded changes, and clear them
+   */
+  void
+  Commit();
+
+private:
+  enum ChangeType {
+    ADD,
+    REPLACE,
+    REMOVE
+  };
+
+  struct Change {
+    Ptr<Node> node;
+    Name prefix;
+    shared_ptr<Face> face;
+    int32_t metric;
+    ChangeType type;
+  };
+
+  std::vector<Change> m_changes;
+};
+
 } // namespace ndn
 
 } // namespace ns3
@@ -53,6 +53,7 @@ namespace ndn {
 StackHelper::StackHelper()
   : m_isForwarderStatusManagerDisabled(false)
   , m_isStrategyChoiceManagerDisabled(false)
+  , m_isForwardingOnly(false)
   , m_needSetDefaultRoutes(false)
   , m_maxCsSize(100)
 {
@@ -195,6 +196,10 @@ StackHelper::doInstall(Ptr<Node> node) const
     ndn->getConfig().put("ndnSIM.disable_strategy_choice_manager", true);
   }
 
+  if (m_isForwardingOnly) {
+    ndn->getConfig().put("ndnSIM.lazy_management", true);
+  }
+
   ndn->getConfig().put("tables.cs_max_packets", (m_maxCsSize == 0) ? 1 : m_maxCsSize);
 
   // Create and aggregate content store if NFD's contest store has been disabled
@@ -396,7 +401,14 @@ StackHelper::createAndRegisterFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetD
 
   if (m_needSetDefaultRoutes) {
     // default route with lowest priority possible
-    FibHelper::AddRoute(node, "/", face, std::numeric_limits<int32_t>::max());
+    if (ndn->isManagementInitialized()) {
+      FibHelper::AddRoute(node, "/", face, std::numeric_limits<int32_t>::max());
+    }
+    else {
+      FibUpdateTransaction fibUpdates;
+      fibUpdates.AddRoute(node, "/", face, std::numeric_limits<int32_t>::max());
+      fibUpdates.Commit();
+    }
   }
   return face;
 }
@@ -413,6 +425,12 @@ StackHelper::disableForwarderStatusManager()
   m_isForwarderStatusManagerDisabled = true;
 }
 
+void
+StackHelper::setForwardingOnly(bool forwardingOnly)
+{
+  m_isForwardingOnly = forwardingOnly;
+}
+
 void
 StackHelper::SetLinkDelayAsFaceMetric()
 {
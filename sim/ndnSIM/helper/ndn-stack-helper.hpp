@@ -234,6 +234,18 @@ public:
   void
   disableForwarderStatusManager();
 
+  /**
+   * \brief Install only the forwarder, its tables and strategies
+   *
+   * Management (dispatcher, face, FIB, CS, strategy choice and forwarder status managers) and
+   * RIB, with their internal faces and config, are created on first use, see
+   * L3Protocol::isManagementInitialized.  Meant for large numbers of transit nodes that never
+   * receive management commands; default routes and StrategyChoiceHelper are applied to their
+   * tables directly.
+   */
+  void
+  setForwardingOnly(bool forwardingOnly = true);
+
   /**
    * @brief Set face metric of all faces connected through PointToPoint channel to channel latency
    */
@@ -259,6 +271,7 @@ private:
 
   bool m_isForwarderStatusManagerDisabled;
   bool m_isStrategyChoiceManagerDisabled;
+  bool m_isForwardingOnly;
 
 public:
   void
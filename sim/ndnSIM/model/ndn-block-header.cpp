@@ -19,21 +19,27 @@
 
 #include "ndn-block-header.hpp"
 
-#include <iosfwd>
-#include <boost/iostreams/concepts.hpp>
-#include <boost/iostreams/stream.hpp>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/channel.h"
 
 #include <ndn-cxx/encoding/tlv.hpp>
 #include <ndn-cxx/interest.hpp>
 #include <ndn-cxx/data.hpp>
 #include <ndn-cxx/lp/packet.hpp>
 
-namespace io = boost::iostreams;
+#include <deque>
+#include <unordered_map>
+
+NS_LOG_COMPONENT_DEFINE("ndn.BlockHeader");
+
 namespace nfdFace = nfd::face;
 
 namespace ns3 {
 namespace ndn {
 
+NS_OBJECT_ENSURE_REGISTERED(BlockTag);
+
 ns3::TypeId
 BlockHeader::GetTypeId()
 {
@@ -73,37 +79,64 @@ BlockHeader::Serialize(ns3::Buffer::Iterator start) const
   start.Write(m_block.wire(), m_block.size());
 }
 
-class Ns3BufferIteratorSource : public io::source {
-public:
-  Ns3BufferIteratorSource(ns3::Buffer::Iterator& is)
-    : m_is(is)
-  {
+/**
+ * @brief Read a TLV-TYPE or TLV-LENGTH number directly from the ns-3 buffer
+ */
+static uint64_t
+readVarNumber(ns3::Buffer::Iterator& is)
+{
+  if (is.IsEnd()) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Insufficient data during TLV parsing"));
   }
 
-  std::streamsize
-  read(char* buf, std::streamsize nMaxRead)
-  {
-    std::streamsize i = 0;
-    for (; i < nMaxRead && !m_is.IsEnd(); ++i) {
-      buf[i] = m_is.ReadU8();
-    }
-    if (i == 0) {
-      return -1;
-    }
-    else {
-      return i;
-    }
+  uint8_t firstOctet = is.ReadU8();
+  size_t size = 0;
+  switch (firstOctet) {
+    case 253:
+      size = 2;
+      break;
+    case 254:
+      size = 4;
+      break;
+    case 255:
+      size = 8;
+      break;
+    default:
+      return firstOctet;
   }
 
-private:
-  ns3::Buffer::Iterator& m_is;
-};
+  if (is.GetRemainingSize() < size) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Insufficient data during TLV parsing"));
+  }
+  switch (size) {
+    case 2:
+      return is.ReadNtohU16();
+    case 4:
+      return is.ReadNtohU32();
+    default:
+      return is.ReadNtohU64();
+  }
+}
 
 uint32_t
 BlockHeader::Deserialize(ns3::Buffer::Iterator start)
 {
-  io::stream<Ns3BufferIteratorSource> is(start);
-  m_block = ::ndn::Block::fromStream(is);
+  // Parse TLV-TYPE and TLV-LENGTH in place, then copy the whole element with a single Read
+  // into a buffer of the exact size, instead of pulling bytes one by one through a stream
+  ns3::Buffer::Iterator i = start;
+  readVarNumber(i);
+  uint64_t length = readVarNumber(i);
+  uint32_t headerSize = i.GetDistanceFrom(start);
+
+  if (length > i.GetRemainingSize()) {
+    BOOST_THROW_EXCEPTION(::ndn::tlv::Error("Not enough data in the buffer to fully parse TLV"));
+  }
+
+  uint32_t size = headerSize + static_cast<uint32_t>(length);
+  auto buffer = make_shared<::ndn::Buffer>(size);
+  start.Read(buffer->data(), size);
+
+  m_block = Block(std::move(buffer));
   return m_block.size();
 }
 
@@ -167,5 +200,165 @@ BlockHeader::getBlock() const
   return m_block;
 }
 
+namespace {
+
+// a block in flight in shared block mode
+struct SharedBlock
+{
+  Block block;
+  uint32_t nReceivers; // receivers yet to extract the block
+};
+
+// blocks in flight in shared block mode, keyed by BlockTag id
+struct SharedBlocks
+{
+  bool isEnabled = false;
+  Time lifetime;
+  uint64_t lastId = 0;
+  std::unordered_map<uint64_t, SharedBlock> blocks;
+  std::deque<std::pair<Time, uint64_t>> expiry; // in order of creation
+};
+
+SharedBlocks&
+getSharedBlocks()
+{
+  static SharedBlocks sharedBlocks;
+  return sharedBlocks;
+}
+
+} // namespace
+
+void
+BlockHeader::SetSharedBlocks(bool isEnabled, Time lifetime)
+{
+  auto& shared = getSharedBlocks();
+  shared.isEnabled = isEnabled;
+  shared.lifetime = lifetime;
+  if (!isEnabled) {
+    shared.blocks.clear();
+    shared.expiry.clear();
+  }
+}
+
+bool
+BlockHeader::IsSharedBlocks()
+{
+  return getSharedBlocks().isEnabled;
+}
+
+Ptr<ns3::Packet>
+BlockHeader::CreatePacket(const Block& block, Ptr<const NetDevice> device)
+{
+  auto& shared = getSharedBlocks();
+  if (!shared.isEnabled) {
+    Ptr<ns3::Packet> packet = Create<ns3::Packet>();
+    packet->AddHeader(BlockHeader(nfdFace::Transport::Packet(Block(block))));
+    return packet;
+  }
+
+  // release blocks of packets that were never received
+  Time now = Simulator::Now();
+  while (!shared.expiry.empty() && shared.expiry.front().first <= now) {
+    shared.blocks.erase(shared.expiry.front().second);
+    shared.expiry.pop_front();
+  }
+
+  uint32_t nReceivers = 1;
+  if (device != nullptr && device->GetChannel() != nullptr && device->GetChannel()->GetNDevices() > 2) {
+    nReceivers = device->GetChannel()->GetNDevices() - 1;
+  }
+
+  uint64_t id = ++shared.lastId;
+  shared.blocks.emplace(id, SharedBlock{block, nReceivers});
+  shared.expiry.emplace_back(now + shared.lifetime, id);
+
+  // zero-filled area is not allocated by ns-3, but counts towards the packet size
+  Ptr<ns3::Packet> packet = Create<ns3::Packet>(block.size());
+  packet->AddPacketTag(BlockTag(id));
+  return packet;
+}
+
+Block
+BlockHeader::ExtractBlock(Ptr<const ns3::Packet> packet)
+{
+  BlockTag tag;
+  if (packet->PeekPacketTag(tag)) {
+    auto& shared = getSharedBlocks();
+    auto i = shared.blocks.find(tag.GetId());
+    if (i == shared.blocks.end()) {
+      NS_LOG_WARN("Shared block " << tag.GetId() << " has been released");
+      return Block();
+    }
+    if (--i->second.nReceivers > 0) {
+      return i->second.block;
+    }
+    Block block = std::move(i->second.block);
+    shared.blocks.erase(i);
+    return block;
+  }
+
+  BlockHeader header;
+  packet->PeekHeader(header);
+  return std::move(header.getBlock());
+}
+
+TypeId
+BlockTag::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::BlockTag")
+    .SetGroupName("Ndn")
+    .SetParent<Tag>()
+    .AddConstructor<BlockTag>()
+    ;
+  return tid;
+}
+
+TypeId
+BlockTag::GetInstanceTypeId() const
+{
+  return GetTypeId();
+}
+
+BlockTag::BlockTag()
+  : m_id(0)
+{
+}
+
+BlockTag::BlockTag(uint64_t id)
+  : m_id(id)
+{
+}
+
+uint64_t
+BlockTag::GetId() const
+{
+  return m_id;
+}
+
+uint32_t
+BlockTag::GetSerializedSize() const
+{
+  return sizeof(uint64_t);
+}
+
+void
+BlockTag::Serialize(TagBuffer i) const
+{
+  i.WriteU64(m_id);
+}
+
+void
+BlockTag::Deserialize(TagBuffer i)
+{
+  m_id = i.ReadU64();
+}
+
+void
+BlockTag::Print(std::ostream& os) const
+{
+  os << "SharedBlock=" << m_id;
+}
+
 } // namespace ndn
 } // namespace ns3
@@ -21,6 +21,10 @@
 #define NDNSIM_NDN_BLOCK_HEADER_HPP
 
 #include "ns3/header.h"
+#include "ns3/net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/tag.h"
 
 #include "ndn-common.hpp"
 
@@ -59,10 +63,83 @@ public:
   const Block&
   getBlock() const;
 
+public: // shared block packet mode
+  /**
+   * \brief Enable or disable shared block mode (disabled by default)
+   *
+   * In shared block mode, packets sent by NetDeviceTransport carry no wire bytes: their payload
+   * is a zero-filled area of the size of the block (so serialization delay and queue occupancy
+   * are unchanged) and a BlockTag refers to the block, which is passed to the receiver without
+   * being encoded or decoded.  Pcap files and Packet::Print do not show NDN packets in this
+   * mode, so it should stay disabled when they are needed.
+   *
+   * A shared block is kept until every other device of the channel it was sent on has received
+   * it.  Blocks of packets that are not received by all of them (e.g., dropped by a queue) are
+   * released after \p lifetime of simulated time.
+   */
+  static void
+  SetSharedBlocks(bool isEnabled, Time lifetime = Seconds(10));
+
+  static bool
+  IsSharedBlocks();
+
+  /**
+   * \brief Create an ns-3 packet for \p block to be sent on \p device, in shared block mode if enabled
+   *
+   * The packet is expected to be received by each other device of the channel of \p device, or
+   * by a single receiver if \p device is not given.
+   */
+  static Ptr<ns3::Packet>
+  CreatePacket(const Block& block, Ptr<const NetDevice> device = nullptr);
+
+  /**
+   * \brief Get the block carried by \p packet, whether it was created in shared block mode or not
+   * \return the block, or an empty block if a shared block has been released
+   * \throw ::ndn::tlv::Error the packet does not contain a valid TLV block
+   */
+  static Block
+  ExtractBlock(Ptr<const ns3::Packet> packet);
+
 private:
   Block m_block;
 };
 
+/**
+ * \brief Packet tag referring to a block passed across a link in shared block mode
+ * \sa BlockHeader::SetSharedBlocks
+ */
+class BlockTag : public Tag {
+public:
+  static TypeId
+  GetTypeId();
+
+  virtual TypeId
+  GetInstanceTypeId() const;
+
+  BlockTag();
+
+  explicit
+  BlockTag(uint64_t id);
+
+  uint64_t
+  GetId() const;
+
+  virtual uint32_t
+  GetSerializedSize() const;
+
+  virtual void
+  Serialize(TagBuffer i) const;
+
+  virtual void
+  Deserialize(TagBuffer i);
+
+  virtual void
+  Print(std::ostream& os) const;
+
+private:
+  uint64_t m_id;
+};
+
 } // namespace ndn
 } // namespace ns3
 
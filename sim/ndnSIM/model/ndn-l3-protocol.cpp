@@ -38,6 +38,9 @@
 
 #include <boost/property_tree/info_parser.hpp>
 
+#include <typeindex>
+#include <unordered_map>
+
 #include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/internal-face.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/internal-transport.hpp"
@@ -208,6 +211,10 @@ private:
 
   Ptr<ContentStore> m_csFromNdnSim;
   PolicyCreationCallback m_policy;
+
+  // indices of faces added with addFace, entries are removed right before faces leave the FaceTable
+  std::unordered_map<const NetDevice*, Face*> m_facesByNetDevice;
+  std::unordered_map<std::type_index, std::vector<Face*>> m_facesByTransportType;
 };
 
 L3Protocol::L3Protocol()
@@ -231,8 +238,33 @@ L3Protocol::initialize()
   // faceTable.addReserved(face::makeNullFace(FaceUri("contentstore://")), face::FACEID_CONTENT_STORE);
   m_impl->m_faceSystem = make_unique<::nfd::face::FaceSystem>(faceTable, nullptr);
 
-  initializeManagement();
-  initializeRibManager();
+  faceTable.beforeRemove.connect([this] (Face& face) {
+      if (m_impl == nullptr) {
+        return; // being disposed
+      }
+
+      auto transport = face.getTransport();
+      auto netDeviceTransport = dynamic_cast<NetDeviceTransport*>(transport);
+      if (netDeviceTransport != nullptr) {
+        auto i = m_impl->m_facesByNetDevice.find(PeekPointer(netDeviceTransport->GetNetDevice()));
+        if (i != m_impl->m_facesByNetDevice.end() && i->second == &face) {
+          m_impl->m_facesByNetDevice.erase(i);
+        }
+      }
+
+      auto typeIt = m_impl->m_facesByTransportType.find(std::type_index(typeid(*transport)));
+      if (typeIt != m_impl->m_facesByTransportType.end()) {
+        auto& faces = typeIt->second;
+        faces.erase(std::remove(faces.begin(), faces.end(), &face), faces.end());
+      }
+    });
+
+  initializeTables();
+
+  if (!this->getConfig().get<bool>("ndnSIM.lazy_management", false)) {
+    initializeManagement();
+    initializeRibManager();
+  }
 
   m_impl->m_forwarder->beforeSatisfyInterest.connect(std::ref(m_satisfiedInterests));
   m_impl->m_forwarder->beforeExpirePendingInterest.connect(std::ref(m_timedOutInterests));
@@ -264,6 +296,7 @@ private:
 void
 L3Protocol::injectInterest(const Interest& interest)
 {
+  ensureManagement();
   m_impl->m_internalClientFaceForInjects->expressInterest(interest, nullptr, nullptr, nullptr);
 }
 
@@ -273,6 +306,29 @@ L3Protocol::setCsReplacementPolicy(const PolicyCreationCallback& policy)
   m_impl->m_policy = policy;
 }
 
+void
+L3Protocol::initializeTables()
+{
+  auto& forwarder = m_impl->m_forwarder;
+  using namespace nfd;
+
+  ConfigFile config(&ConfigFile::ignoreUnknownSection);
+
+  // if we use NFD's CS, we have to specify a replacement policy
+  m_impl->m_csFromNdnSim = GetObject<ContentStore>();
+  if (m_impl->m_csFromNdnSim == nullptr) {
+    forwarder->getCs().setPolicy(m_impl->m_policy());
+  }
+
+  TablesConfigSection tablesConfig(*forwarder);
+  tablesConfig.setConfigFile(config);
+
+  // apply config
+  config.parse(m_impl->m_config, false, "ndnSIM.conf");
+
+  tablesConfig.ensureConfigured();
+}
+
 void
 L3Protocol::initializeManagement()
 {
@@ -307,26 +363,15 @@ L3Protocol::initializeManagement()
 
   ConfigFile config(&ConfigFile::ignoreUnknownSection);
 
-  // if we use NFD's CS, we have to specify a replacement policy
-  m_impl->m_csFromNdnSim = GetObject<ContentStore>();
-  if (m_impl->m_csFromNdnSim == nullptr) {
-    forwarder->getCs().setPolicy(m_impl->m_policy());
-  }
-
-  TablesConfigSection tablesConfig(*forwarder);
-  tablesConfig.setConfigFile(config);
-
   m_impl->m_authenticator->setConfigFile(config);
 
   // if (!this->getConfig().get<bool>("ndnSIM.disable_face_manager", false)) {
   m_impl->m_faceSystem->setConfigFile(config);
   // }
 
-  // apply config
+  // apply config, tables have been configured by initializeTables
   config.parse(m_impl->m_config, false, "ndnSIM.conf");
 
-  tablesConfig.ensureConfigured();
-
   // add FIB entry for NFD Management Protocol
   Name topPrefix("/localhost/nfd");
   // m_impl->m_forwarder->getFib().insert(topPrefix).first->addOrUpdateNextHop(*m_impl->m_internalFace, 0, 0);
@@ -348,6 +393,24 @@ L3Protocol::initializeRibManager()
                                                    std::ref(StackHelper::getKeyChain()));
 }
 
+void
+L3Protocol::ensureManagement()
+{
+  if (isManagementInitialized()) {
+    return;
+  }
+
+  NS_LOG_DEBUG("Initializing management on first use");
+  initializeManagement();
+  initializeRibManager();
+}
+
+bool
+L3Protocol::isManagementInitialized() const
+{
+  return m_impl->m_dispatcher != nullptr;
+}
+
 shared_ptr<nfd::Forwarder>
 L3Protocol::getForwarder()
 {
@@ -357,18 +420,21 @@ L3Protocol::getForwarder()
 shared_ptr<nfd::FibManager>
 L3Protocol::getFibManager()
 {
+  ensureManagement();
   return m_impl->m_fibManager;
 }
 
 nfd::StrategyChoiceManager&
 L3Protocol::getStrategyChoiceManager()
 {
+  ensureManagement();
   return *m_impl->m_strategyChoiceManager;
 }
 
 ::nfd::rib::Service&
 L3Protocol::getRibService()
 {
+  ensureManagement();
   return *m_impl->m_ribService;
 }
 
@@ -421,8 +487,20 @@ L3Protocol::addFace(shared_ptr<Face> face)
 {
   NS_LOG_FUNCTION(this << face.get());
 
+  // applications on the node may send management commands, e.g., to register prefixes
+  if (face->getScope() == ::ndn::nfd::FACE_SCOPE_LOCAL) {
+    ensureManagement();
+  }
+
   m_impl->m_forwarder->addFace(face);
 
+  auto transport = face->getTransport();
+  auto netDeviceTransport = dynamic_cast<NetDeviceTransport*>(transport);
+  if (netDeviceTransport != nullptr) {
+    m_impl->m_facesByNetDevice[PeekPointer(netDeviceTransport->GetNetDevice())] = face.get();
+  }
+  m_impl->m_facesByTransportType[std::type_index(typeid(*transport))].push_back(face.get());
+
   std::weak_ptr<Face> weakFace = face;
 
   // // Connect Signals to TraceSource
@@ -482,15 +560,23 @@ L3Protocol::getFaceById(nfd::FaceId id) const
 shared_ptr<Face>
 L3Protocol::getFaceByNetDevice(Ptr<NetDevice> netDevice) const
 {
-  for (auto& i : m_impl->m_forwarder->getFaceTable()) {
-    auto transport = dynamic_cast<NetDeviceTransport*>(i.getTransport());
-    if (transport == nullptr)
-      continue;
+  auto i = m_impl->m_facesByNetDevice.find(PeekPointer(netDevice));
+  if (i == m_impl->m_facesByNetDevice.end())
+    return nullptr;
 
-    if (transport->GetNetDevice() == netDevice)
-      return i.shared_from_this();
-  }
-  return nullptr;
+  return i->second->shared_from_this();
+}
+
+const std::vector<Face*>&
+L3Protocol::getFacesByTransportType(const std::type_info& transportType) const
+{
+  static const std::vector<Face*> noFaces;
+
+  auto i = m_impl->m_facesByTransportType.find(std::type_index(transportType));
+  if (i == m_impl->m_facesByTransportType.end())
+    return noFaces;
+
+  return i->second;
 }
 
 Ptr<L3Protocol>
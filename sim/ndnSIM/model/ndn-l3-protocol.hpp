@@ -23,6 +23,7 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
 #include <list>
+#include <typeinfo>
 #include <vector>
 
 #include "ns3/ptr.h"
@@ -119,6 +120,16 @@ public:
   ::nfd::rib::Service&
   getRibService();
 
+  /**
+   * \brief Whether management (and RIB) has been created
+   *
+   * With config option ndnSIM.lazy_management (see StackHelper::setForwardingOnly), management
+   * and RIB are created on first use: through the getters above, injectInterest, or when a
+   * face with local scope (application face) is added.
+   */
+  bool
+  isManagementInitialized() const;
+
   /**
    * \brief Add face to NDN stack
    *
@@ -146,10 +157,21 @@ public:
 
   /**
    * \brief Get face for NetDevice
+   *
+   * Faces are indexed by NetDevice when added with addFace and removed from the index when
+   * they are closed, so the lookup does not depend on the size of the FaceTable
    */
   shared_ptr<Face>
   getFaceByNetDevice(Ptr<NetDevice> netDevice) const;
 
+  /**
+   * \brief Get faces whose transport is exactly of the specified type, in order of addition
+   *
+   * Example: getFacesByTransportType(typeid(NetDeviceTransport))
+   */
+  const std::vector<Face*>&
+  getFacesByTransportType(const std::type_info& transportType) const;
+
   /**
    * \brief Get NFD config (boost::property_tree)
    */
@@ -198,12 +220,18 @@ private:
   void
   initialize();
 
+  void
+  initializeTables();
+
   void
   initializeManagement();
 
   void
   initializeRibManager();
 
+  void
+  ensureManagement();
+
 private:
   class Impl;
   std::unique_ptr<Impl> m_impl;
@@ -147,10 +147,7 @@ NetDeviceTransport::doSend(Packet&& packet)
                   << this->getLocalUri());
 
   // convert NFD packet to NS3 packet
-  BlockHeader header(packet);
-
-  Ptr<ns3::Packet> ns3Packet = Create<ns3::Packet>();
-  ns3Packet->AddHeader(header);
+  Ptr<ns3::Packet> ns3Packet = BlockHeader::CreatePacket(packet.packet, m_netDevice);
 
   // send the NS3 packet
   m_netDevice->Send(ns3Packet, m_netDevice->GetBroadcast(),
@@ -168,12 +165,10 @@ NetDeviceTransport::receiveFromNetDevice(Ptr<NetDevice> device,
   NS_LOG_FUNCTION(device << p << protocol << from << to << packetType);
 
   // Convert NS3 packet to NFD packet
-  Ptr<ns3::Packet> packet = p->Copy();
-
-  BlockHeader header;
-  packet->RemoveHeader(header);
-
-  auto nfdPacket = Packet(std::move(header.getBlock()));
+  auto nfdPacket = Packet(BlockHeader::ExtractBlock(p));
+  if (nfdPacket.packet.empty()) {
+    return;
+  }
 
   this->receive(std::move(nfdPacket));
 }
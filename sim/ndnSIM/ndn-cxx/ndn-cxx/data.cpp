@@ -130,6 +130,7 @@ Data::wireDecode(const Block& wire)
 
   m_wire = wire;
   m_wire.parse();
+  m_nameHashes.clear();
 
   auto element = m_wire.elements_begin();
   if (element == m_wire.elements_end() || element->type() != tlv::Name) {
@@ -218,6 +219,7 @@ Data::setName(const Name& name)
 {
   resetWire();
   m_name = name;
+  m_nameHashes.clear();
   return *this;
 }
 
@@ -132,6 +132,17 @@ public: // Data fields
   Data&
   setName(const Name& name);
 
+  /** @brief Get the cache of Name prefix hashes
+   *
+   *  The cache is empty until filled by a user such as the forwarder's NameTree, and is
+   *  cleared whenever the Name changes.
+   */
+  std::vector<size_t>&
+  getNameHashCache() const
+  {
+    return m_nameHashes;
+  }
+
   /** @brief Get MetaInfo
    */
   const MetaInfo&
@@ -242,6 +253,7 @@ private:
 
   mutable Block m_wire;
   mutable Name m_fullName; ///< cached FullName computed from m_wire
+  mutable std::vector<size_t> m_nameHashes; ///< cached Name prefix hashes, see getNameHashCache
 };
 
 #ifndef DOXYGEN
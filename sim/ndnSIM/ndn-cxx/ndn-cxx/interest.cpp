@@ -219,6 +219,7 @@ Interest::wireDecode(const Block& wire)
 {
   m_wire = wire;
   m_wire.parse();
+  m_nameHashes.clear();
 
   if (m_wire.type() != tlv::Interest) {
     BOOST_THROW_EXCEPTION(Error("expecting Interest element, got " + to_string(m_wire.type())));
@@ -141,9 +141,22 @@ public: // element access
   {
     m_name = name;
     m_wire.reset();
+    m_nameHashes.clear();
     return *this;
   }
 
+  /** @brief Get the cache of Name prefix hashes
+   *
+   *  The cache is empty until filled by a user such as the forwarder's NameTree, and is
+   *  cleared whenever the Name changes, so that one hash computation can be shared by every
+   *  table that looks up this Interest.
+   */
+  std::vector<size_t>&
+  getNameHashCache() const
+  {
+    return m_nameHashes;
+  }
+
   /** @brief Declare the default CanBePrefix setting of the application.
    *
    *  As part of transitioning to NDN Packet Format v0.3, the default setting for CanBePrefix
@@ -484,6 +497,7 @@ private:
   Block m_parameters; // NDN Packet Format v0.3 only
 
   mutable Block m_wire;
+  mutable std::vector<size_t> m_nameHashes; ///< cached Name prefix hashes, see getNameHashCache
 
   friend bool operator==(const Interest& lhs, const Interest& rhs);
 };
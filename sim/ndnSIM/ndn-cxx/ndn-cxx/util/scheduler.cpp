@@ -27,48 +27,107 @@ namespace ndn {
 namespace util {
 namespace scheduler {
 
-/** \brief Stores internal information about a scheduled event
+static const uint32_t INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+static const size_t HEAP_ARITY = 4;
+
+/** \brief Stores the events of all schedulers in reusable slots
+ *
+ *  A slot is pending while it has an owner. Releasing a slot increments its generation, which
+ *  invalidates every EventId of the event. The pool is never destroyed, so that an EventId can
+ *  be checked or cancelled after its scheduler is gone, as when ndnSIM resets the global
+ *  scheduler of NFD before all tables are destroyed.
  */
-class EventInfo : noncopyable
+class EventPool : noncopyable
 {
 public:
-  EventInfo(time::nanoseconds after, const EventCallback& callback)
-    : expireTime(time::steady_clock::now() + after)
-    , isExpired(false)
-    , callback(callback)
+  struct Slot
   {
+    EventCallback callback;
+    Scheduler* owner = nullptr;
+    uint32_t heapIndex = 0;
+    uint32_t generation = 0;
+    uint32_t nextFree = INVALID_SLOT;
+  };
+
+  static EventPool&
+  get()
+  {
+    static EventPool* pool = new EventPool;
+    return *pool;
   }
 
-  time::nanoseconds
-  expiresFromNow() const
+  uint32_t
+  allocate(Scheduler* owner, EventCallback callback)
   {
-    return std::max(expireTime - time::steady_clock::now(), 0_ns);
+    uint32_t slot = m_freeHead;
+    if (slot != INVALID_SLOT) {
+      m_freeHead = m_slots[slot].nextFree;
+    }
+    else {
+      slot = static_cast<uint32_t>(m_slots.size());
+      m_slots.emplace_back();
+    }
+    m_slots[slot].owner = owner;
+    m_slots[slot].callback = std::move(callback);
+    return slot;
   }
 
-public:
-  time::steady_clock::TimePoint expireTime;
-  bool isExpired;
-  EventCallback callback;
-  EventQueue::const_iterator queueIt;
+  /** \brief Free \p slot for reuse
+   *  \return the callback of the event
+   */
+  EventCallback
+  release(uint32_t slot)
+  {
+    Slot& s = m_slots[slot];
+    EventCallback callback = std::move(s.callback);
+    s.callback = nullptr;
+    s.owner = nullptr;
+    ++s.generation;
+    s.nextFree = m_freeHead;
+    m_freeHead = slot;
+    return callback;
+  }
+
+  bool
+  isPending(uint32_t slot, uint32_t generation) const noexcept
+  {
+    return slot < m_slots.size() && m_slots[slot].generation == generation &&
+           m_slots[slot].owner != nullptr;
+  }
+
+  Slot&
+  operator[](uint32_t slot)
+  {
+    return m_slots[slot];
+  }
+
+private:
+  std::vector<Slot> m_slots;
+  uint32_t m_freeHead = INVALID_SLOT;
 };
 
-EventId::EventId(Scheduler& sched, weak_ptr<EventInfo> info)
-  : CancelHandle([&sched, info] { sched.cancelImpl(info.lock()); })
-  , m_info(std::move(info))
+EventId::EventId(uint32_t slot, uint32_t generation)
+  : CancelHandle([slot, generation] {
+      EventPool& pool = EventPool::get();
+      if (pool.isPending(slot, generation)) {
+        pool[slot].owner->cancelImpl(slot);
+      }
+    })
+  , m_slot(slot)
+  , m_generation(generation)
 {
 }
 
 EventId::operator bool() const noexcept
 {
-  auto sp = m_info.lock();
-  return sp != nullptr && !sp->isExpired;
+  return EventPool::get().isPending(m_slot, m_generation);
 }
 
 bool
 EventId::operator==(const EventId& other) const noexcept
 {
   return (!*this && !other) ||
-         !(m_info.owner_before(other.m_info) || other.m_info.owner_before(m_info));
+         (m_slot == other.m_slot && m_generation == other.m_generation);
 }
 
 void
@@ -80,17 +139,15 @@ EventId::reset() noexcept
 std::ostream&
 operator<<(std::ostream& os, const EventId& eventId)
 {
-  return os << eventId.m_info.lock();
-}
-
-bool
-EventQueueCompare::operator()(const shared_ptr<EventInfo>& a, const shared_ptr<EventInfo>& b) const noexcept
-{
-  return a->expireTime < b->expireTime;
+  if (!eventId) {
+    return os << 0;
+  }
+  return os << eventId.m_slot << ':' << eventId.m_generation;
 }
 
 Scheduler::Scheduler(DummyIoService& ioService)
-  : m_isEventExecuting(false)
+  : m_nextSeq(0)
+  , m_isEventExecuting(false)
 {
 }
 
@@ -100,47 +157,47 @@ Scheduler::~Scheduler()
 }
 
 EventId
-Scheduler::scheduleEvent(time::nanoseconds after, const EventCallback& callback)
+Scheduler::scheduleEvent(time::nanoseconds after, EventCallback callback)
 {
   BOOST_ASSERT(callback != nullptr);
 
-  EventQueue::iterator i = m_queue.insert(make_shared<EventInfo>(after, callback));
-  (*i)->queueIt = i;
+  EventPool& pool = EventPool::get();
+  uint32_t slot = pool.allocate(this, std::move(callback));
+  m_heap.push_back({time::steady_clock::now() + after, m_nextSeq++, slot});
+  this->siftUp(m_heap.size() - 1);
 
-  if (!m_isEventExecuting && i == m_queue.begin()) {
+  if (!m_isEventExecuting && pool[slot].heapIndex == 0) {
     // the new event is the first one to expire
     this->scheduleNext();
   }
 
-  return EventId(*this, *i);
+  return EventId(slot, pool[slot].generation);
 }
 
 void
-Scheduler::cancelImpl(const shared_ptr<EventInfo>& info)
+Scheduler::cancelImpl(uint32_t slot)
 {
-  if (info == nullptr || info->isExpired) {
-    return;
-  }
-
-  if (info->queueIt == m_queue.begin()) {
-    if (m_timerEvent) {
-      if (!m_timerEvent->IsExpired()) {
-        ns3::Simulator::Remove(*m_timerEvent);
-      }
-      m_timerEvent.reset();
-    }
-  }
-  m_queue.erase(info->queueIt);
+  EventPool& pool = EventPool::get();
+  BOOST_ASSERT(pool[slot].owner == this);
 
-  if (!m_isEventExecuting) {
-    this->scheduleNext();
-  }
+  // a wakeup for the cancelled event is kept, it re-arms for the next event when it expires
+  this->removeAt(pool[slot].heapIndex);
+  pool.release(slot);
 }
 
 void
 Scheduler::cancelAllEvents()
 {
-  m_queue.clear();
+  EventPool& pool = EventPool::get();
+
+  // callbacks are destroyed after all slots are released, as they may cancel other events
+  std::vector<EventCallback> callbacks;
+  callbacks.reserve(m_heap.size());
+  for (const HeapNode& node : m_heap) {
+    callbacks.push_back(pool.release(node.slot));
+  }
+  m_heap.clear();
+
   if (m_timerEvent) {
     if (!m_timerEvent->IsExpired()) {
       ns3::Simulator::Remove(*m_timerEvent);
@@ -152,10 +209,21 @@ Scheduler::cancelAllEvents()
 void
 Scheduler::scheduleNext()
 {
-  if (!m_queue.empty()) {
-    m_timerEvent = ns3::Simulator::Schedule(ns3::NanoSeconds((*m_queue.begin())->expiresFromNow().count()),
-                                            &Scheduler::executeEvent, this);
+  if (m_heap.empty()) {
+    return;
   }
+
+  auto expireTime = m_heap.front().expireTime;
+  if (m_timerEvent && !m_timerEvent->IsExpired()) {
+    if (m_wakeupTime <= expireTime) {
+      return;
+    }
+    ns3::Simulator::Cancel(*m_timerEvent);
+  }
+
+  m_wakeupTime = expireTime;
+  auto after = std::max(expireTime - time::steady_clock::now(), 0_ns);
+  m_timerEvent = ns3::Simulator::Schedule(ns3::NanoSeconds(after.count()), &Scheduler::executeEvent, this);
 }
 
 void
@@ -170,18 +238,83 @@ Scheduler::executeEvent()
   } BOOST_SCOPE_EXIT_END
 
   // process all expired events
+  EventPool& pool = EventPool::get();
   auto now = time::steady_clock::now();
-  while (!m_queue.empty()) {
-    auto head = m_queue.begin();
-    shared_ptr<EventInfo> info = *head;
-    if (info->expireTime > now) {
+  while (!m_heap.empty() && m_heap.front().expireTime <= now) {
+    uint32_t slot = m_heap.front().slot;
+    this->removeAt(0);
+    EventCallback callback = pool.release(slot);
+    callback();
+  }
+}
+
+void
+Scheduler::removeAt(size_t index)
+{
+  size_t last = m_heap.size() - 1;
+  if (index != last) {
+    m_heap[index] = m_heap[last];
+  }
+  m_heap.pop_back();
+
+  if (index < m_heap.size()) {
+    // the moved node may belong above or below its new position
+    if (index > 0 && m_heap[index] < m_heap[(index - 1) / HEAP_ARITY]) {
+      this->siftUp(index);
+    }
+    else {
+      this->siftDown(index);
+    }
+  }
+}
+
+void
+Scheduler::siftUp(size_t index)
+{
+  HeapNode node = m_heap[index];
+  while (index > 0) {
+    size_t parent = (index - 1) / HEAP_ARITY;
+    if (!(node < m_heap[parent])) {
       break;
     }
+    m_heap[index] = m_heap[parent];
+    this->place(index);
+    index = parent;
+  }
+  m_heap[index] = node;
+  this->place(index);
+}
 
-    m_queue.erase(head);
-    info->isExpired = true;
-    info->callback();
+void
+Scheduler::siftDown(size_t index)
+{
+  HeapNode node = m_heap[index];
+  while (true) {
+    size_t first = index * HEAP_ARITY + 1;
+    if (first >= m_heap.size()) {
+      break;
+    }
+    size_t earliest = first;
+    for (size_t child = first + 1; child < std::min(first + HEAP_ARITY, m_heap.size()); ++child) {
+      if (m_heap[child] < m_heap[earliest]) {
+        earliest = child;
+      }
+    }
+    if (!(m_heap[earliest] < node)) {
+      break;
+    }
+    m_heap[index] = m_heap[earliest];
+    this->place(index);
+    index = earliest;
   }
+  m_heap[index] = node;
+  this->place(index);
+}
+
+void
+Scheduler::place(size_t index)
+{
+  EventPool::get()[m_heap[index].slot].heapIndex = static_cast<uint32_t>(index);
 }
 
 } // namespace scheduler
@@ -28,14 +28,14 @@
 
 #include "ns3/simulator.h"
 
-#include <set>
+#include <vector>
 
 namespace ndn {
 namespace util {
 namespace scheduler {
 
 class Scheduler;
-class EventInfo;
+class EventPool;
 
 /** \brief Function to be invoked when a scheduled event expires
  */
@@ -92,10 +92,12 @@ public:
   reset() noexcept;
 
 private:
-  EventId(Scheduler& sched, weak_ptr<EventInfo> info);
+  EventId(uint32_t slot, uint32_t generation);
 
 private:
-  weak_ptr<EventInfo> m_info;
+  // the slot of the event in the EventPool, valid while the slot has the same generation
+  uint32_t m_slot = std::numeric_limits<uint32_t>::max();
+  uint32_t m_generation = 0;
 
   friend class Scheduler;
   friend std::ostream& operator<<(std::ostream& os, const EventId& eventId);
@@ -136,16 +138,15 @@ public:
   }
 };
 
-class EventQueueCompare
-{
-public:
-  bool
-  operator()(const shared_ptr<EventInfo>& a, const shared_ptr<EventInfo>& b) const noexcept;
-};
-
-using EventQueue = std::multiset<shared_ptr<EventInfo>, EventQueueCompare>;
-
 /** \brief Generic scheduler
+ *
+ *  Events of all schedulers are kept in pooled slots of a process-wide EventPool, so scheduling
+ *  reuses slots instead of allocating, and an EventId is a slot index and generation that stays
+ *  safe to use after its scheduler is gone. Each scheduler orders its events in a 4-ary heap,
+ *  and keeps a single ns-3 event to wake up at the earliest expiry: it is re-created only when
+ *  an earlier event is scheduled, and a wakeup left by a cancelled event just re-arms.
+ *
+ *  \note Like the ns-3 simulator, the scheduler is not thread-safe.
  */
 class Scheduler : noncopyable
 {
@@ -159,7 +160,7 @@ public:
    *  \return EventId that can be used to cancel the scheduled event
    */
   EventId
-  scheduleEvent(time::nanoseconds after, const EventCallback& callback);
+  scheduleEvent(time::nanoseconds after, EventCallback callback);
 
   /** \brief Cancel a scheduled event
    *
@@ -177,10 +178,12 @@ public:
   cancelAllEvents();
 
 private:
+  /** \brief Remove the event in \p slot from the heap and release the slot
+   */
   void
-  cancelImpl(const shared_ptr<EventInfo>& info);
+  cancelImpl(uint32_t slot);
 
-  /** \brief Schedule the next event on the deadline timer
+  /** \brief Schedule the ns-3 wakeup for the earliest event, unless an earlier one is pending
    */
   void
   scheduleNext();
@@ -190,10 +193,39 @@ private:
   void
   executeEvent();
 
+  /** \brief Remove the heap node at \p index, restoring the heap order
+   */
+  void
+  removeAt(size_t index);
+
+  void
+  siftUp(size_t index);
+
+  void
+  siftDown(size_t index);
+
+  void
+  place(size_t index);
+
 private:
-  EventQueue m_queue;
+  struct HeapNode
+  {
+    time::steady_clock::TimePoint expireTime;
+    uint64_t seq; ///< events expiring at the same time execute in the order they are scheduled
+    uint32_t slot;
+
+    bool
+    operator<(const HeapNode& other) const noexcept
+    {
+      return expireTime < other.expireTime || (expireTime == other.expireTime && seq < other.seq);
+    }
+  };
+
+  std::vector<HeapNode> m_heap;
+  uint64_t m_nextSeq;
   bool m_isEventExecuting;
   ndn::optional<ns3::EventId> m_timerEvent;
+  time::steady_clock::TimePoint m_wakeupTime; ///< time of m_timerEvent
 
   friend EventId;
 };
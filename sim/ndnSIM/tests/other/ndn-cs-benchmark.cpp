@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-cs-benchmark.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "ns3/ndnSIM/NFD/daemon/table/cs.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace ns3 {
+
+/**
+ * Measures inserts into nfd::Cs, and lookups of stored Names with CanBePrefix=false, served by
+ * the hash index, and with CanBePrefix=true, served by the ordered table.
+ *
+ *     ./waf --run ndn-cs-benchmark --command-template="%s --csSize=10000 --n=1000000"
+ */
+class Tester {
+public:
+  Tester()
+    : m_csSize(10000)
+    , m_nIterations(1000000)
+  {
+  }
+
+  int
+  run(int argc, char* argv[]);
+
+private:
+  void
+  measureFind(const std::string& label, const std::vector<ndn::Interest>& interests);
+
+private:
+  uint32_t m_csSize;
+  uint32_t m_nIterations;
+  std::unique_ptr<::nfd::Cs> m_cs;
+};
+
+void
+Tester::measureFind(const std::string& label, const std::vector<ndn::Interest>& interests)
+{
+  size_t nHits = 0;
+  size_t nMisses = 0;
+
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < m_nIterations; ++i) {
+    m_cs->find(interests[i % interests.size()],
+               [&] (const ndn::Interest&, const ndn::Data&) { ++nHits; },
+               [&] (const ndn::Interest&) { ++nMisses; });
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+  std::cout << label << "\t" << m_cs->size() << "\t" << us << "\t"
+            << static_cast<double>(us) * 1000 / m_nIterations << "\t"
+            << nHits << "\t" << nMisses << "\n";
+}
+
+int
+Tester::run(int argc, char* argv[])
+{
+  CommandLine cmd;
+  cmd.AddValue("csSize", "Number of Data packets stored in the CS", m_csSize);
+  cmd.AddValue("n", "Number of operations of each kind", m_nIterations);
+  cmd.Parse(argc, argv);
+
+#ifdef _DEBUG
+  std::cerr << "Benchmark compiled in debug mode is unreliable, please compile in release mode.\n";
+#endif
+
+  // Names as sent by the sat consumers: /sat/<producer>/<consumer>/<seq>
+  std::vector<std::shared_ptr<ndn::Data>> packets;
+  for (uint32_t i = 0; i < 2 * m_csSize; ++i) {
+    auto data = std::make_shared<ndn::Data>(ndn::Name("/sat/city-producer/city-consumer").appendNumber(i));
+    data->setContent(std::make_shared<::ndn::Buffer>(1024));
+    ndn::SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+    data->setSignature(ndn::Signature(signatureInfo,
+                                      ::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0)));
+    data->wireEncode();
+    packets.push_back(data);
+  }
+
+  m_cs.reset(new ::nfd::Cs(m_csSize));
+
+  // inserts, the second half of the packets evict the first half
+  auto t1 = std::chrono::steady_clock::now();
+  for (const auto& data : packets) {
+    m_cs->insert(*data);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  auto insertUs = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<uint32_t> stored(m_csSize, 2 * m_csSize - 1);
+  std::uniform_int_distribution<uint32_t> evicted(0, m_csSize - 1);
+  std::vector<ndn::Interest> exactHits, prefixHits, exactMisses;
+  for (uint32_t i = 0; i < std::min<uint32_t>(m_nIterations, 65536); ++i) {
+    ndn::Interest interest(packets[stored(rng)]->getName());
+    interest.setCanBePrefix(false);
+    exactHits.push_back(interest);
+    interest.setCanBePrefix(true);
+    prefixHits.push_back(interest);
+
+    ndn::Interest miss(packets[evicted(rng)]->getName());
+    miss.setCanBePrefix(false);
+    exactMisses.push_back(miss);
+  }
+
+  std::cout << "Operation\tCsSize\tTotal(us)\tPerOp(ns)\tHits\tMisses\n";
+  std::cout << "Insert\t" << m_cs->size() << "\t" << insertUs << "\t"
+            << static_cast<double>(insertUs) * 1000 / packets.size() << "\t-\t-\n";
+  measureFind("FindExact", exactHits);
+  measureFind("FindPrefix", prefixHits);
+  measureFind("FindExactMiss", exactMisses);
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  ns3::Tester tester;
+  return tester.run(argc, argv);
+}
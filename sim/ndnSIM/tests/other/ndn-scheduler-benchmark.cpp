@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// ndn-scheduler-benchmark.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+namespace ns3 {
+
+/**
+ * Measures the ndn-cxx Scheduler used by NFD in ndnSIM:
+ * - Schedule: scheduling timers with random delays on top of --pending events
+ * - Cancel: cancelling them in random order
+ * - Renew: the PIT expiry pattern, cancelling a timer and scheduling it again on each Interest,
+ *   then running the simulator until all timers have expired
+ *
+ *     ./waf --run ndn-scheduler-benchmark --command-template="%s --n=1000000 --pending=10000"
+ */
+class Tester {
+public:
+  Tester()
+    : m_nIterations(1000000)
+    , m_nPending(10000)
+    , m_nExecuted(0)
+  {
+  }
+
+  int
+  run(int argc, char* argv[]);
+
+private:
+  void
+  report(const std::string& label, std::chrono::steady_clock::time_point start);
+
+  void
+  renew(size_t i);
+
+private:
+  uint32_t m_nIterations;
+  uint32_t m_nPending;
+  uint64_t m_nExecuted;
+  ::ndn::DummyIoService m_io;
+  std::unique_ptr<::ndn::Scheduler> m_scheduler;
+  std::vector<::ndn::util::scheduler::EventId> m_timers;
+  std::mt19937 m_rng;
+};
+
+void
+Tester::report(const std::string& label, std::chrono::steady_clock::time_point start)
+{
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << label << "\t" << m_nIterations << "\t" << us << "\t"
+            << static_cast<double>(us) * 1000 / m_nIterations << "\n";
+}
+
+void
+Tester::renew(size_t i)
+{
+  std::uniform_int_distribution<int> delay(1, 4000);
+  m_timers[i].cancel();
+  m_timers[i] = m_scheduler->scheduleEvent(::ndn::time::milliseconds(delay(m_rng)), [this] { ++m_nExecuted; });
+}
+
+int
+Tester::run(int argc, char* argv[])
+{
+  CommandLine cmd;
+  cmd.AddValue("n", "Number of operations of each kind", m_nIterations);
+  cmd.AddValue("pending", "Number of events pending in the scheduler during the measurements", m_nPending);
+  cmd.Parse(argc, argv);
+  m_nPending = std::max<uint32_t>(m_nPending, 1);
+
+#ifdef _DEBUG
+  std::cerr << "Benchmark compiled in debug mode is unreliable, please compile in release mode.\n";
+#endif
+
+  m_scheduler.reset(new ::ndn::Scheduler(m_io));
+  std::uniform_int_distribution<int> delay(1, 4000);
+  auto onExpire = [this] { ++m_nExecuted; };
+
+  std::vector<::ndn::util::scheduler::EventId> pending;
+  for (uint32_t i = 0; i < m_nPending; ++i) {
+    pending.push_back(m_scheduler->scheduleEvent(::ndn::time::milliseconds(delay(m_rng)), onExpire));
+  }
+
+  std::cout << "Operation\tN\tTotal(us)\tPerOp(ns)\n";
+
+  std::vector<::ndn::util::scheduler::EventId> events;
+  events.reserve(m_nIterations);
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < m_nIterations; ++i) {
+    events.push_back(m_scheduler->scheduleEvent(::ndn::time::milliseconds(delay(m_rng)), onExpire));
+  }
+  report("Schedule", t1);
+
+  std::shuffle(events.begin(), events.end(), m_rng);
+  t1 = std::chrono::steady_clock::now();
+  for (auto& event : events) {
+    event.cancel();
+  }
+  report("Cancel", t1);
+  events.clear();
+
+  // PIT-like timers: each Interest renews the expiry timer of one of the pending entries
+  m_timers.swap(pending);
+  t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < m_nIterations; ++i) {
+    Simulator::Schedule(NanoSeconds(i), &Tester::renew, this, i % m_timers.size());
+  }
+  Simulator::Run();
+  report("Renew+Run", t1);
+
+  std::cout << "Executed " << m_nExecuted << " timers\n";
+
+  m_timers.clear();
+  m_scheduler.reset();
+  Simulator::Destroy();
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  ns3::Tester tester;
+  return tester.run(argc, argv);
+}
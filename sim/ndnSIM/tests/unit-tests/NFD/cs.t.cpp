@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/ndnSIM/NFD/daemon/table/cs.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class CsFixture : public CleanupFixture
+{
+public:
+  CsFixture()
+    : cs(10)
+  {
+  }
+
+  shared_ptr<Data>
+  insert(const Name& name, uint8_t content = 0)
+  {
+    auto data = make_shared<Data>(name);
+    data->setContent(&content, 1);
+    SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+    data->setSignature(Signature(signatureInfo, ::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0)));
+    data->wireEncode();
+    cs.insert(*data);
+    return data;
+  }
+
+  shared_ptr<const Data>
+  find(const Name& name, bool canBePrefix, bool isRightmost = false)
+  {
+    Interest interest(name);
+    interest.setCanBePrefix(canBePrefix);
+    if (isRightmost) {
+      interest.setChildSelector(1);
+    }
+
+    shared_ptr<const Data> found;
+    cs.find(interest,
+            [&] (const Interest&, const Data& data) { found = data.shared_from_this(); },
+            [] (const Interest&) {});
+    return found;
+  }
+
+public:
+  nfd::Cs cs;
+};
+
+BOOST_FIXTURE_TEST_SUITE(NfdCs, CsFixture)
+
+BOOST_AUTO_TEST_CASE(ExactMatch)
+{
+  insert("/a");
+  insert("/a/b");
+  insert("/a/c");
+
+  BOOST_REQUIRE(find("/a", false) != nullptr);
+  BOOST_CHECK_EQUAL(find("/a", false)->getName(), "/a");
+  BOOST_CHECK_EQUAL(find("/a/b", false)->getName(), "/a/b");
+  BOOST_CHECK(find("/a/b/c", false) == nullptr);
+  BOOST_CHECK(find("/b", false) == nullptr);
+
+  // prefix lookups still use the ordered table
+  BOOST_CHECK_EQUAL(find("/a", true, true)->getName(), "/a/c");
+}
+
+BOOST_AUTO_TEST_CASE(SameNameDifferentDigest)
+{
+  auto data1 = insert("/x", 1);
+  auto data2 = insert("/x", 2);
+  BOOST_CHECK_EQUAL(cs.size(), 2);
+
+  // same choice as the ordered table
+  BOOST_CHECK_EQUAL(find("/x", false)->getFullName(), find("/x", true)->getFullName());
+  BOOST_CHECK_EQUAL(find("/x", false, true)->getFullName(), find("/x", true, true)->getFullName());
+  BOOST_CHECK_NE(find("/x", false)->getFullName(), find("/x", false, true)->getFullName());
+
+  // full name lookups
+  BOOST_CHECK_EQUAL(find(data1->getFullName(), false)->getFullName(), data1->getFullName());
+  BOOST_CHECK_EQUAL(find(data2->getFullName(), false)->getFullName(), data2->getFullName());
+}
+
+BOOST_AUTO_TEST_CASE(EvictAndErase)
+{
+  cs.setLimit(2);
+  insert("/1");
+  insert("/2");
+  insert("/3");
+  BOOST_CHECK_EQUAL(cs.size(), 2);
+
+  BOOST_CHECK(find("/1", false) == nullptr);
+  BOOST_CHECK(find("/2", false) != nullptr);
+  BOOST_CHECK(find("/3", false) != nullptr);
+
+  size_t nErased = 0;
+  cs.erase("/", 10, [&] (size_t n) { nErased = n; });
+  BOOST_CHECK_EQUAL(nErased, 2);
+  BOOST_CHECK(find("/2", false) == nullptr);
+  BOOST_CHECK(find("/3", false) == nullptr);
+
+  insert("/2");
+  BOOST_CHECK(find("/2", false) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
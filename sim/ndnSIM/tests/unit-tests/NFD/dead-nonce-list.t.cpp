@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/ndnSIM/NFD/daemon/table/dead-nonce-list.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(NfdDeadNonceList, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(IdleListSchedulesNothing)
+{
+  nfd::DeadNonceList dnl;
+
+  // no event is pending, so the simulation ends right away
+  Simulator::Run();
+  BOOST_CHECK_EQUAL(Simulator::Now(), Seconds(0));
+  BOOST_CHECK_EQUAL(dnl.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ResumeAndPark)
+{
+  nfd::DeadNonceList dnl(::ndn::time::milliseconds(100));
+  Name name("/sat/producer/consumer/1");
+
+  bool hasAfterAdd = false;
+  nfd::scheduler::schedule(::ndn::time::seconds(1), [&] {
+      dnl.add(name, 42);
+      hasAfterAdd = dnl.has(name, 42);
+    });
+
+  // the timers run until the Nonce is evicted, then they are parked again
+  Simulator::Run();
+  BOOST_CHECK(hasAfterAdd);
+  BOOST_CHECK_GT(Simulator::Now(), Seconds(1));
+  BOOST_CHECK_EQUAL(dnl.size(), 0);
+  BOOST_CHECK(!dnl.has(name, 42));
+}
+
+BOOST_AUTO_TEST_CASE(ComponentOrderAndRepetition)
+{
+  nfd::DeadNonceList dnl;
+  dnl.add(Name("/a/b/b/c"), 42);
+  dnl.add(Name("/x/y/z"), 42);
+
+  // Names with the same XOR of component hashes do not share entries
+  BOOST_CHECK(dnl.has(Name("/a/b/b/c"), 42));
+  BOOST_CHECK(!dnl.has(Name("/a/d/d/c"), 42));
+  BOOST_CHECK(!dnl.has(Name("/a/c/b/b"), 42));
+  BOOST_CHECK(!dnl.has(Name("/z/y/x"), 42));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/ndnSIM/NFD/daemon/table/dead-nonce-list.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/pit.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+BOOST_FIXTURE_TEST_SUITE(NfdNameHashCache, CleanupFixture)
+
+BOOST_AUTO_TEST_CASE(FillAndInvalidate)
+{
+  Interest interest("/sat/producer/consumer/1");
+  BOOST_CHECK(interest.getNameHashCache().empty());
+
+  const auto& hashes = nfd::name_tree::getHashes(interest);
+  BOOST_CHECK(hashes == nfd::name_tree::computeHashes(interest.getName()));
+  BOOST_CHECK_EQUAL(interest.getNameHashCache().size(), 5);
+
+  Interest copy(interest.wireEncode());
+  BOOST_CHECK(copy.getNameHashCache().empty());
+
+  interest.setName("/sat/producer/consumer/2");
+  BOOST_CHECK(interest.getNameHashCache().empty());
+  BOOST_CHECK(nfd::name_tree::getHashes(interest) == nfd::name_tree::computeHashes("/sat/producer/consumer/2"));
+
+  Data data("/sat/producer/consumer/1");
+  nfd::name_tree::getHashes(data);
+  BOOST_CHECK_EQUAL(data.getNameHashCache().size(), 5);
+  data.setName("/sat/producer/consumer/2");
+  BOOST_CHECK(data.getNameHashCache().empty());
+}
+
+BOOST_AUTO_TEST_CASE(PitAndDeadNonceList)
+{
+  nfd::NameTree nameTree(16);
+  nfd::Pit pit(nameTree);
+
+  Interest interest("/sat/producer/consumer/1");
+  interest.setNonce(42);
+  auto entry = pit.insert(interest).first;
+  BOOST_CHECK_EQUAL(interest.getNameHashCache().size(), 5);
+  BOOST_CHECK(pit.find(interest) == entry);
+
+  Data data("/sat/producer/consumer/1");
+  BOOST_CHECK_EQUAL(pit.findAllDataMatches(data).size(), 1);
+
+  // overloads taking a Name and an Interest record the same entry
+  nfd::DeadNonceList dnl;
+  dnl.add(interest, 42);
+  BOOST_CHECK(dnl.has(interest.getName(), 42));
+  BOOST_CHECK(dnl.has(interest, 42));
+  BOOST_CHECK(!dnl.has(interest, 43));
+  BOOST_CHECK(!dnl.has(Name("/sat/producer/consumer"), 42));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "apps/ndn-producer.hpp"
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+class ProducerFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  ProducerFixture()
+  {
+    Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("10Mbps"));
+    Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+    Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("20p"));
+
+    createTopology({
+        {"1", "2"}
+      });
+
+    addRoutes({
+        {"1", "2", "/prefix", 1}
+      });
+  }
+
+  void
+  addProducer(const std::string& reuseEncoding)
+  {
+    addApps({
+        {"1", "ns3::ndn::ConsumerCbr",
+            {{"Prefix", "/prefix"}, {"Frequency", "10"}},
+            "0s", "0.25s"},
+        {"2", "ns3::ndn::Producer",
+            {{"Prefix", "/prefix"}, {"PayloadSize", "1000"}, {"Freshness", "2s"},
+             {"Signature", "42"}, {"KeyLocator", "/key"}, {"ReuseEncoding", reuseEncoding}},
+            "0s", "100s"}
+      });
+
+    getNode("2")->GetApplication(0)->TraceConnectWithoutContext("TransmittedDatas",
+                                                               MakeCallback(&ProducerFixture::onData, this));
+  }
+
+  void
+  onData(shared_ptr<const Data> data, Ptr<App> app, shared_ptr<Face> face)
+  {
+    // Data as encoded by Producer before encodings were reused
+    Data expected(data->getName());
+    expected.setFreshnessPeriod(::ndn::time::seconds(2));
+    expected.setContent(make_shared<::ndn::Buffer>(1000));
+    SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+    signatureInfo.setKeyLocator(Name("/key"));
+    Signature signature(signatureInfo);
+    signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 42));
+    expected.setSignature(signature);
+
+    const Block& wire = data->wireEncode();
+    const Block& expectedWire = expected.wireEncode();
+    BOOST_CHECK_EQUAL_COLLECTIONS(wire.begin(), wire.end(), expectedWire.begin(), expectedWire.end());
+    BOOST_CHECK_EQUAL(data->getContent().value_size(), 1000);
+    nData++;
+  }
+
+public:
+  size_t nData = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(AppsNdnProducer, ProducerFixture)
+
+BOOST_AUTO_TEST_CASE(Default)
+{
+  addProducer("false");
+
+  Simulator::Stop(Seconds(1));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(nData, 3);
+}
+
+BOOST_AUTO_TEST_CASE(ReuseEncoding)
+{
+  addProducer("true");
+
+  Simulator::Stop(Seconds(1));
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(nData, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -18,6 +18,10 @@
  **/
 
 #include "helper/ndn-fib-helper.hpp"
+#include "model/ndn-l3-protocol.hpp"
+
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/fib.hpp"
 
 #include "../tests-common.hpp"
 
@@ -97,8 +101,125 @@ BOOST_AUTO_TEST_CASE(Helper4)
   FibHelper::AddRoute(getNode("1"), Name("/prefix"), getNode("2"), 10);
 }
 
+BOOST_AUTO_TEST_CASE(Transaction)
+{
+  FibUpdateTransaction transaction;
+  transaction.AddRoute(getNode("1"), Name("/prefix"), getNode("2"), 10);
+  BOOST_CHECK_EQUAL(transaction.GetSize(), 1);
+  transaction.Commit();
+  BOOST_CHECK_EQUAL(transaction.GetSize(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // AddRoute
 
+class TransactionFixture : public ScenarioHelperWithCleanupFixture
+{
+public:
+  TransactionFixture()
+  {
+    createTopology({
+        {"1", "2"},
+        {"1", "3"},
+        {"2", "3"}
+      });
+  }
+
+  const nfd::fib::Entry*
+  findEntry(const std::string& node, const Name& prefix)
+  {
+    return getNode(node)->GetObject<L3Protocol>()->getForwarder()->getFib().findExactMatch(prefix);
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(TransactionCommit, TransactionFixture)
+{
+  FibUpdateTransaction transaction;
+  transaction.AddRoute(getNode("1"), Name("/a"), getFace("1", "2"), 1);
+  transaction.AddRoute(getNode("1"), Name("/a"), getNode("3"), 2);
+  transaction.AddRoute(getNode("2"), Name("/b"), getFace("2", "3"), 3);
+
+  // nothing is applied before Commit
+  BOOST_CHECK(findEntry("1", "/a") == nullptr);
+  transaction.Commit();
+
+  auto entry = findEntry("1", "/a");
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_CHECK_EQUAL(entry->getNextHops().size(), 2);
+  BOOST_CHECK(entry->hasNextHop(*getFace("1", "2"), 0));
+  BOOST_CHECK(entry->hasNextHop(*getFace("1", "3"), 0));
+  BOOST_REQUIRE(findEntry("2", "/b") != nullptr);
+  BOOST_CHECK_EQUAL(findEntry("2", "/b")->getNextHops().front().getCost(), 3);
+
+  // changes are applied in order, the entry is erased with its last next hop
+  transaction.RemoveRoute(getNode("1"), Name("/a"), getFace("1", "2"));
+  transaction.AddRoute(getNode("2"), Name("/b"), getFace("2", "3"), 5);
+  transaction.RemoveRoute(getNode("2"), Name("/b"), getNode("3"));
+  transaction.RemoveRoute(getNode("3"), Name("/c"), getFace("3", "1")); // no such entry
+  transaction.Commit();
+
+  entry = findEntry("1", "/a");
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_CHECK_EQUAL(entry->getNextHops().size(), 1);
+  BOOST_CHECK(entry->hasNextHop(*getFace("1", "3"), 0));
+  BOOST_CHECK(findEntry("2", "/b") == nullptr);
+  BOOST_CHECK(findEntry("3", "/c") == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(TransactionSignalsAndClosedFaces, TransactionFixture)
+{
+  auto& fib = getNode("1")->GetObject<L3Protocol>()->getForwarder()->getFib();
+  std::vector<Name> newNextHops;
+  ::ndn::util::signal::ScopedConnection connection =
+    fib.afterNewNextHop.connect([&] (const Name& prefix, const nfd::fib::NextHop&) {
+        newNextHops.push_back(prefix);
+      });
+
+  // strategies are notified of new next hops when the transaction is committed
+  FibUpdateTransaction transaction;
+  transaction.AddRoute(getNode("1"), Name("/a"), getFace("1", "2"), 1);
+  BOOST_CHECK(newNextHops.empty());
+  transaction.Commit();
+  BOOST_REQUIRE_EQUAL(newNextHops.size(), 1);
+  BOOST_CHECK_EQUAL(newNextHops.front(), Name("/a"));
+
+  // changes on a face closed before the commit are skipped
+  auto face = getFace("1", "3");
+  transaction.AddRoute(getNode("1"), Name("/b"), face, 1);
+  transaction.ReplaceRoute(getNode("1"), Name("/a"), face, 1);
+  transaction.RemoveRoute(getNode("1"), Name("/a"), getFace("1", "2"));
+  face->close();
+  BOOST_CHECK_EQUAL(face->getId(), nfd::face::INVALID_FACEID);
+  transaction.Commit();
+
+  BOOST_CHECK_EQUAL(newNextHops.size(), 1);
+  BOOST_CHECK(findEntry("1", "/b") == nullptr);
+  BOOST_CHECK(findEntry("1", "/a") == nullptr); // the removal of the other next hop was applied
+}
+
+BOOST_FIXTURE_TEST_CASE(TransactionReplace, TransactionFixture)
+{
+  FibUpdateTransaction transaction;
+  transaction.AddRoute(getNode("1"), Name("/a"), getFace("1", "2"), 1);
+  transaction.Commit();
+
+  // the last replacement for the same prefix wins, whatever the FIB held before the transaction
+  transaction.ReplaceRoute(getNode("1"), Name("/a"), getFace("1", "3"), 2);
+  transaction.ReplaceRoute(getNode("1"), Name("/a"), getFace("1", "2"), 3);
+  BOOST_CHECK(findEntry("1", "/a")->hasNextHop(*getFace("1", "2"), 0));
+  transaction.Commit();
+
+  auto entry = findEntry("1", "/a");
+  BOOST_REQUIRE(entry != nullptr);
+  BOOST_REQUIRE_EQUAL(entry->getNextHops().size(), 1);
+  BOOST_CHECK(entry->hasNextHop(*getFace("1", "2"), 0));
+  BOOST_CHECK_EQUAL(entry->getNextHops().front().getCost(), 3);
+
+  transaction.ReplaceRoute(getNode("1"), Name("/a"), getFace("1", "3"), 1);
+  transaction.Commit();
+  BOOST_REQUIRE_EQUAL(findEntry("1", "/a")->getNextHops().size(), 1);
+  BOOST_CHECK(findEntry("1", "/a")->hasNextHop(*getFace("1", "3"), 0));
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperNdnFibHelper
 
 } // namespace ndn
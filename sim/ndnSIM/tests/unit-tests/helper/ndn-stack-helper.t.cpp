@@ -62,6 +62,41 @@ BOOST_AUTO_TEST_CASE(TestNfdContentStorePolicy)
   BOOST_CHECK_EQUAL(protoNode1->getForwarder()->getCs().getPolicy()->getName(), "priority_fifo");
 }
 
+BOOST_AUTO_TEST_CASE(TestForwardingOnly)
+{
+  NodeContainer nodes;
+  nodes.Create(2);
+
+  PointToPointHelper p2p;
+  p2p.Install(nodes.Get(0), nodes.Get(1));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.setForwardingOnly();
+  ndnHelper.InstallAll();
+
+  Ptr<L3Protocol> proto = L3Protocol::getL3Protocol(nodes.Get(0));
+  BOOST_CHECK(!proto->isManagementInitialized());
+  BOOST_CHECK_EQUAL(proto->getForwarder()->getCs().getPolicy()->getName(), "lru");
+
+  // default routes and strategies are applied to the tables directly
+  auto& fib = proto->getForwarder()->getFib();
+  BOOST_REQUIRE(fib.findExactMatch("/") != nullptr);
+  BOOST_CHECK_EQUAL(fib.findExactMatch("/")->getNextHops().size(), 1);
+  BOOST_CHECK(fib.findExactMatch("/localhost/nfd") == nullptr);
+
+  StrategyChoiceHelper::Install(nodes.Get(0), "/prefix", "/localhost/nfd/strategy/multicast");
+  BOOST_CHECK_EQUAL(proto->getForwarder()->getStrategyChoice().findEffectiveStrategy("/prefix").getInstanceName().getPrefix(-1),
+                    Name("/localhost/nfd/strategy/multicast"));
+  BOOST_CHECK(!proto->isManagementInitialized());
+
+  // management is created on first use
+  BOOST_CHECK(proto->getFibManager() != nullptr);
+  BOOST_CHECK(proto->isManagementInitialized());
+  BOOST_CHECK(fib.findExactMatch("/localhost/nfd") != nullptr);
+  BOOST_CHECK(!L3Protocol::getL3Protocol(nodes.Get(1))->isManagementInitialized());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
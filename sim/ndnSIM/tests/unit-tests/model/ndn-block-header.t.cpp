@@ -24,6 +24,9 @@
 
 #include "ns3/ndnSIM/NFD/daemon/face/transport.hpp"
 #include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
 
 #include "../tests-common.hpp"
 
@@ -157,6 +160,87 @@ BOOST_AUTO_TEST_CASE(PrintLpPacket)
   }
 }
 
+BOOST_AUTO_TEST_CASE(DeserializeRoundTrip)
+{
+  Data data("/other/prefix");
+  data.setContent(std::make_shared< ::ndn::Buffer>(1024));
+  ndn::StackHelper::getKeyChain().sign(data);
+  lp::Packet lpPacket(data.wireEncode());
+  Block wire = lpPacket.wireEncode(); // TLV-LENGTH takes 3 octets
+
+  Ptr<Packet> packet = Create<Packet>();
+  packet->AddHeader(BlockHeader(nfd::face::Transport::Packet(Block(wire))));
+  packet->AddPaddingAtEnd(10); // trailing bytes must be left in the packet
+
+  BlockHeader header;
+  BOOST_CHECK_EQUAL(packet->RemoveHeader(header), wire.size());
+  BOOST_CHECK_EQUAL(packet->GetSize(), 10);
+  BOOST_CHECK_EQUAL_COLLECTIONS(header.getBlock().begin(), header.getBlock().end(),
+                                wire.begin(), wire.end());
+
+  ::ndn::Buffer::const_iterator first, last;
+  std::tie(first, last) = lp::Packet(header.getBlock()).get<lp::FragmentField>(0);
+  BOOST_CHECK_EQUAL(Data(Block(&*first, std::distance(first, last))).getName(), "/other/prefix");
+}
+
+BOOST_AUTO_TEST_CASE(DeserializeTruncated)
+{
+  Interest interest("/prefix");
+  interest.setNonce(10);
+  interest.setCanBePrefix(true);
+  const Block& wire = interest.wireEncode();
+
+  ns3::Buffer buffer;
+  buffer.AddAtStart(wire.size() - 1);
+  buffer.Begin().Write(wire.wire(), wire.size() - 1);
+
+  BlockHeader header;
+  BOOST_CHECK_THROW(header.Deserialize(buffer.Begin()), ::ndn::tlv::Error);
+
+  ns3::Buffer empty;
+  BOOST_CHECK_THROW(header.Deserialize(empty.Begin()), ::ndn::tlv::Error);
+}
+
+BOOST_AUTO_TEST_CASE(SharedBlocks)
+{
+  Interest interest("/prefix");
+  interest.setNonce(10);
+  interest.setCanBePrefix(true);
+  const Block& wire = interest.wireEncode();
+
+  Ptr<Packet> encoded = BlockHeader::CreatePacket(wire);
+  BOOST_CHECK_EQUAL(encoded->GetSize(), wire.size());
+  BOOST_CHECK(BlockHeader::ExtractBlock(encoded) == wire);
+
+  BlockHeader::SetSharedBlocks(true);
+  Ptr<Packet> shared = BlockHeader::CreatePacket(wire);
+  BOOST_CHECK_EQUAL(shared->GetSize(), wire.size());
+  Block received = BlockHeader::ExtractBlock(shared->Copy());
+  BOOST_CHECK(received == wire);
+  BOOST_CHECK(received.wire() == wire.wire()); // same storage
+  BOOST_CHECK(BlockHeader::ExtractBlock(shared).empty()); // released after its only receiver
+
+  // a block sent on a channel with several receivers is kept until each of them received it
+  Ptr<Node> node = CreateObject<Node>();
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+  std::vector<Ptr<SimpleNetDevice>> devices;
+  for (int i = 0; i < 3; i++) {
+    devices.push_back(CreateObject<SimpleNetDevice>());
+    node->AddDevice(devices.back());
+    devices.back()->SetChannel(channel);
+  }
+  Ptr<Packet> broadcast = BlockHeader::CreatePacket(wire, devices[0]);
+  BOOST_CHECK(BlockHeader::ExtractBlock(broadcast->Copy()) == wire);
+  BOOST_CHECK(BlockHeader::ExtractBlock(broadcast->Copy()) == wire);
+  BOOST_CHECK(BlockHeader::ExtractBlock(broadcast).empty());
+
+  // packets encoded before the mode was switched are still understood
+  BOOST_CHECK(BlockHeader::ExtractBlock(encoded) == wire);
+
+  BlockHeader::SetSharedBlocks(false);
+  BOOST_CHECK(BlockHeader::ExtractBlock(BlockHeader::CreatePacket(wire)) == wire);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace ndn
@@ -19,6 +19,8 @@
 
 #include "helper/ndn-scenario-helper.hpp"
 #include "helper/ndn-app-helper.hpp"
+#include "model/ndn-l3-protocol.hpp"
+#include "model/ndn-net-device-transport.hpp"
 
 #include <ndn-cxx/face.hpp>
 
@@ -124,6 +126,36 @@ BOOST_AUTO_TEST_CASE(DisabledForwarderStatusManager)
 
 BOOST_AUTO_TEST_SUITE_END() // ManagerCheck
 
+BOOST_AUTO_TEST_CASE(FaceIndices)
+{
+  createTopology({
+      {"1", "2"},
+      {"1", "3"},
+    });
+
+  auto ndn = getNode("1")->GetObject<L3Protocol>();
+
+  auto face12 = ndn->getFaceByNetDevice(getNetDevice("1", "2"));
+  auto face13 = ndn->getFaceByNetDevice(getNetDevice("1", "3"));
+  BOOST_REQUIRE(face12 != nullptr);
+  BOOST_REQUIRE(face13 != nullptr);
+  BOOST_CHECK_EQUAL(face12, getFace("1", "2"));
+  BOOST_CHECK_EQUAL(face13, getFace("1", "3"));
+  BOOST_CHECK(ndn->getFaceByNetDevice(getNetDevice("2", "1")) == nullptr);
+
+  auto& faces = ndn->getFacesByTransportType(typeid(NetDeviceTransport));
+  BOOST_REQUIRE_EQUAL(faces.size(), 2);
+  BOOST_CHECK_EQUAL(faces[0], face12.get());
+  BOOST_CHECK_EQUAL(faces[1], face13.get());
+  BOOST_CHECK(ndn->getFacesByTransportType(typeid(int)).empty());
+
+  face12->close();
+  BOOST_CHECK(ndn->getFaceByNetDevice(getNetDevice("1", "2")) == nullptr);
+  BOOST_CHECK_EQUAL(ndn->getFaceByNetDevice(getNetDevice("1", "3")), face13);
+  BOOST_REQUIRE_EQUAL(faces.size(), 1);
+  BOOST_CHECK_EQUAL(faces[0], face13.get());
+}
+
 BOOST_AUTO_TEST_SUITE_END() // ModelNdnL3Protocol
 
 } // namespace ndn
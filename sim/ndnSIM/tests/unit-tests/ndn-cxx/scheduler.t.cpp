@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include "../tests-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+using ::ndn::util::scheduler::EventId;
+using ::ndn::util::scheduler::ScopedEventId;
+
+class SchedulerFixture : public CleanupFixture
+{
+public:
+  ::ndn::DummyIoService io;
+};
+
+BOOST_FIXTURE_TEST_SUITE(NdnCxxScheduler, SchedulerFixture)
+
+BOOST_AUTO_TEST_CASE(Order)
+{
+  ::ndn::Scheduler scheduler(io);
+  std::vector<int> executed;
+  std::vector<Time> times;
+  auto record = [&] (int i) {
+    return [&, i] {
+      executed.push_back(i);
+      times.push_back(Simulator::Now());
+    };
+  };
+
+  scheduler.scheduleEvent(::ndn::time::milliseconds(30), record(3));
+  scheduler.scheduleEvent(::ndn::time::milliseconds(10), record(1));
+  scheduler.scheduleEvent(::ndn::time::milliseconds(20), record(2));
+  // same expiry, executed in the order of scheduling
+  scheduler.scheduleEvent(::ndn::time::milliseconds(20), record(4));
+  scheduler.scheduleEvent(::ndn::time::milliseconds(5), [&] {
+      scheduler.scheduleEvent(::ndn::time::milliseconds(1), record(0));
+    });
+
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL_COLLECTIONS(executed.begin(), executed.end(),
+                                std::vector<int>({0, 1, 2, 4, 3}).begin(),
+                                std::vector<int>({0, 1, 2, 4, 3}).end());
+  BOOST_REQUIRE_EQUAL(times.size(), 5);
+  BOOST_CHECK_EQUAL(times[0], MilliSeconds(6));
+  BOOST_CHECK_EQUAL(times[1], MilliSeconds(10));
+  BOOST_CHECK_EQUAL(times[4], MilliSeconds(30));
+}
+
+BOOST_AUTO_TEST_CASE(Cancel)
+{
+  ::ndn::Scheduler scheduler(io);
+  int nExecuted = 0;
+  auto count = [&] { ++nExecuted; };
+
+  EventId first = scheduler.scheduleEvent(::ndn::time::milliseconds(10), count);
+  EventId second = scheduler.scheduleEvent(::ndn::time::milliseconds(20), count);
+  EventId third = scheduler.scheduleEvent(::ndn::time::milliseconds(30), count);
+  BOOST_CHECK(first);
+  BOOST_CHECK(first != second);
+
+  // cancel the first event, its wakeup re-arms for the second one
+  first.cancel();
+  BOOST_CHECK(!first);
+  BOOST_CHECK(first == EventId());
+  scheduler.scheduleEvent(::ndn::time::milliseconds(15), [&] { third.cancel(); });
+  {
+    ScopedEventId scoped = scheduler.scheduleEvent(::ndn::time::milliseconds(1), count);
+  }
+
+  Simulator::Run();
+
+  BOOST_CHECK_EQUAL(nExecuted, 1);
+  BOOST_CHECK(!second);
+  BOOST_CHECK_EQUAL(Simulator::Now(), MilliSeconds(20));
+
+  // a reused slot does not revive an expired EventId
+  EventId fourth = scheduler.scheduleEvent(::ndn::time::milliseconds(10), count);
+  BOOST_CHECK(fourth);
+  BOOST_CHECK(!second);
+  second.cancel();
+  BOOST_CHECK(fourth);
+}
+
+BOOST_AUTO_TEST_CASE(OutliveScheduler)
+{
+  int nExecuted = 0;
+  EventId eventId;
+  {
+    ::ndn::Scheduler scheduler(io);
+    eventId = scheduler.scheduleEvent(::ndn::time::milliseconds(10), [&] { ++nExecuted; });
+    BOOST_CHECK(eventId);
+  }
+  BOOST_CHECK(!eventId);
+  eventId.cancel();
+
+  Simulator::Run();
+  BOOST_CHECK_EQUAL(nExecuted, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace ndn
+} // namespace ns3
@@ -190,7 +190,27 @@ L3RateTracer::SetAveragingPeriod(const Time& period)
 {
   m_period = period;
   m_printEvent.Cancel();
-  m_printEvent = Simulator::Schedule(m_period, &L3RateTracer::PeriodicPrinter, this);
+  m_nextPrint = Simulator::Now() + m_period;
+  if (!m_stats.empty()) {
+    m_printEvent = Simulator::Schedule(m_period, &L3RateTracer::PeriodicPrinter, this);
+  }
+  // otherwise nothing would be printed, the printer is started by the first counted packet
+}
+
+void
+L3RateTracer::WakeUp()
+{
+  if (!m_stats.empty()) {
+    return;
+  }
+
+  // skip the print times that passed while idle, keeping the phase of the printer
+  Time now = Simulator::Now();
+  if (m_nextPrint <= now) {
+    int64_t nSkipped = (now - m_nextPrint).GetTimeStep() / m_period.GetTimeStep() + 1;
+    m_nextPrint = TimeStep(m_nextPrint.GetTimeStep() + nSkipped * m_period.GetTimeStep());
+  }
+  m_printEvent = Simulator::Schedule(m_nextPrint - now, &L3RateTracer::PeriodicPrinter, this);
 }
 
 void
@@ -296,6 +316,7 @@ L3RateTracer::Print(std::ostream& os) const
 void
 L3RateTracer::OutInterests(const Interest& interest, const Face& face)
 {
+  WakeUp();
   AddInfo(face);
   std::get<0>(m_stats[face.getId()]).m_outInterests++;
   if (interest.hasWire()) {
@@ -307,6 +328,7 @@ L3RateTracer::OutInterests(const Interest& interest, const Face& face)
 void
 L3RateTracer::InInterests(const Interest& interest, const Face& face)
 {
+  WakeUp();
   AddInfo(face);
   std::get<0>(m_stats[face.getId()]).m_inInterests++;
   if (interest.hasWire()) {
@@ -318,6 +340,7 @@ L3RateTracer::InInterests(const Interest& interest, const Face& face)
 void
 L3RateTracer::OutData(const Data& data, const Face& face)
 {
+  WakeUp();
   AddInfo(face);
   std::get<0>(m_stats[face.getId()]).m_outData++;
   if (data.hasWire()) {
@@ -329,6 +352,7 @@ L3RateTracer::OutData(const Data& data, const Face& face)
 void
 L3RateTracer::InData(const Data& data, const Face& face)
 {
+  WakeUp();
   AddInfo(face);
   std::get<0>(m_stats[face.getId()]).m_inData++;
   if (data.hasWire()) {
@@ -340,6 +364,7 @@ L3RateTracer::InData(const Data& data, const Face& face)
 void
 L3RateTracer::OutNack(const lp::Nack& nack, const Face& face)
 {
+  WakeUp();
   AddInfo(face);
   std::get<0>(m_stats[face.getId()]).m_outNack++;
   if (nack.getInterest().hasWire()) {
@@ -351,6 +376,7 @@ L3RateTracer::OutNack(const lp::Nack& nack, const Face& face)
 void
 L3RateTracer::InNack(const lp::Nack& nack, const Face& face)
 {
+  WakeUp();
   AddInfo(face);
   std::get<0>(m_stats[face.getId()]).m_inNack++;
   if (nack.getInterest().hasWire()) {
@@ -362,6 +388,7 @@ L3RateTracer::InNack(const lp::Nack& nack, const Face& face)
 void
 L3RateTracer::SatisfiedInterests(const nfd::pit::Entry& entry, const Face&, const Data&)
 {
+  WakeUp();
   std::get<0>(m_stats[nfd::face::INVALID_FACEID]).m_satisfiedInterests++;
   // no "size" stats
 
@@ -379,6 +406,7 @@ L3RateTracer::SatisfiedInterests(const nfd::pit::Entry& entry, const Face&, cons
 void
 L3RateTracer::TimedOutInterests(const nfd::pit::Entry& entry)
 {
+  WakeUp();
   std::get<0>(m_stats[nfd::face::INVALID_FACEID]).m_timedOutInterests++;
   // no "size" stats
 
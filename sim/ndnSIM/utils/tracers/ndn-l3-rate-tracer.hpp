@@ -158,6 +158,15 @@ private:
   void
   PeriodicPrinter();
 
+  /**
+   * @brief Starts the periodic printer on the first counted packet
+   *
+   * The printer is not scheduled while there are no counters, as it would print nothing,
+   * so that idle nodes do not keep the simulator busy.
+   */
+  void
+  WakeUp();
+
   void
   Reset();
 
@@ -168,6 +177,7 @@ private:
   shared_ptr<std::ostream> m_os;
   Time m_period;
   EventId m_printEvent;
+  Time m_nextPrint; // when the printer is due, kept while it is not scheduled
 
   mutable std::map<nfd::FaceId, std::tuple<Stats, Stats, Stats, Stats>> m_stats;
   std::map<nfd::FaceId, std::string> m_faceInfos; // needed, because face may no longer exists at the time of stat printing
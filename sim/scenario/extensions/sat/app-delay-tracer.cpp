@@ -36,15 +36,13 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/make_shared.hpp>
 
-#include <fstream>
-
 NS_LOG_COMPONENT_DEFINE("ndn.sat.AppDelayTracer");
 
 namespace ns3 {
 namespace ndn {
 namespace sat {
 
-static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<AppDelayTracer>>>>
+static std::list<std::tuple<shared_ptr<TraceSink>, std::list<Ptr<AppDelayTracer>>>>
   g_tracers;
 
 void
@@ -56,118 +54,58 @@ AppDelayTracer::Destroy()
 void
 AppDelayTracer::InstallAll(const std::string& file)
 {
-  using namespace boost;
-  using namespace std;
-
   std::list<Ptr<AppDelayTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> sink = TraceSink::Open(file, GetColumns());
+  if (sink == nullptr) {
+    return;
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<AppDelayTracer> trace = Install(*node, outputStream);
+    Ptr<AppDelayTracer> trace = Install(*node, sink);
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
-    // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
-  }
-
-  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+  g_tracers.push_back(std::make_tuple(sink, tracers));
 }
 
 void
 AppDelayTracer::Install(const NodeContainer& nodes, const std::string& file)
 {
-  using namespace boost;
-  using namespace std;
-
   std::list<Ptr<AppDelayTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> sink = TraceSink::Open(file, GetColumns());
+  if (sink == nullptr) {
+    return;
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
-    Ptr<AppDelayTracer> trace = Install(*node, outputStream);
+    Ptr<AppDelayTracer> trace = Install(*node, sink);
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
-    // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
-  }
-
-  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+  g_tracers.push_back(std::make_tuple(sink, tracers));
 }
 
 void
 AppDelayTracer::Install(Ptr<Node> node, const std::string& file)
 {
-  using namespace boost;
-  using namespace std;
-
   std::list<Ptr<AppDelayTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> sink = TraceSink::Open(file, GetColumns());
+  if (sink == nullptr) {
+    return;
   }
 
-  Ptr<AppDelayTracer> trace = Install(node, outputStream);
+  Ptr<AppDelayTracer> trace = Install(node, sink);
   tracers.push_back(trace);
 
-  if (tracers.size() > 0) {
-    // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
-  }
-
-  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+  g_tracers.push_back(std::make_tuple(sink, tracers));
 }
 
 Ptr<AppDelayTracer>
-AppDelayTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream)
+AppDelayTracer::Install(Ptr<Node> node, shared_ptr<TraceSink> sink)
 {
   NS_LOG_DEBUG("Node: " << node->GetId());
 
-  Ptr<AppDelayTracer> trace = Create<AppDelayTracer>(outputStream, node);
+  Ptr<AppDelayTracer> trace = Create<AppDelayTracer>(sink, node);
 
   return trace;
 }
@@ -176,9 +114,9 @@ AppDelayTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream)
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 
-AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+AppDelayTracer::AppDelayTracer(shared_ptr<TraceSink> sink, Ptr<Node> node)
   : m_nodePtr(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   m_node = boost::lexical_cast<std::string>(m_nodePtr->GetId());
 
@@ -190,9 +128,9 @@ AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
   }
 }
 
-AppDelayTracer::AppDelayTracer(shared_ptr<std::ostream> os, const std::string& node)
+AppDelayTracer::AppDelayTracer(shared_ptr<TraceSink> sink, const std::string& node)
   : m_node(node)
-  , m_os(os)
+  , m_sink(sink)
 {
   Connect();
 }
@@ -214,75 +152,65 @@ AppDelayTracer::Connect()
                                 MakeCallback(&AppDelayTracer::LostInterest, this));
 }
 
-void
-AppDelayTracer::PrintHeader(std::ostream& os) const
+const TraceSink::Columns&
+AppDelayTracer::GetColumns()
 {
-  os << "Time"
-     << "\t"
-     << "Node"
-     << "\t"
-     << "AppId"
-     << "\t"
-     << "Prefix"
-     << "\t"
-     << "SeqNo"
-     << "\t"
-
-     << "Type"
-     << "\t"
-     << "DelayS"
-     << "\t"
-     << "DelayUS"
-     << "\t"
-     << "RetxCount"
-     << "\t"
-     << "HopCount";
+  static const TraceSink::Columns columns = {
+    {"Time", TraceSink::REAL},
+    {"Node", TraceSink::STRING},
+    {"AppId", TraceSink::INTEGER},
+    {"Prefix", TraceSink::STRING},
+    {"SeqNo", TraceSink::INTEGER},
+
+    {"Type", TraceSink::STRING},
+    {"DelayS", TraceSink::REAL},
+    {"DelayUS", TraceSink::REAL},
+    {"RetxCount", TraceSink::INTEGER},
+    {"HopCount", TraceSink::INTEGER},
+  };
+  return columns;
 }
 
 void
-AppDelayTracer::LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay,
-                                                   int32_t hopCount)
+AppDelayTracer::Record(Ptr<App> app, uint32_t seqno, const std::string& type, double delayS,
+                       double delayUS, uint32_t retxCount, int32_t hopCount)
 {
   auto pConsumerApp = app->GetObject<ConsumerCbr>();
   BOOST_ASSERT(pConsumerApp);
   StringValue prefix;
   pConsumerApp->GetAttribute("Prefix", prefix);
-  *m_os << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << app->GetId() << "\t"
-        << prefix.Get() << "\t"
-        << seqno << "\t"
-        << "LastDelay"
-        << "\t" << delay.ToDouble(Time::S) << "\t" << delay.ToDouble(Time::US) << "\t" << 1 << "\t"
-        << hopCount << "\n";
+  m_sink->AddReal(Simulator::Now().ToDouble(Time::S));
+  m_sink->AddString(m_node);
+  m_sink->AddInteger(app->GetId());
+  m_sink->AddString(prefix.Get());
+  m_sink->AddInteger(seqno);
+  m_sink->AddString(type);
+  m_sink->AddReal(delayS);
+  m_sink->AddReal(delayUS);
+  m_sink->AddInteger(retxCount);
+  m_sink->AddInteger(hopCount);
+  m_sink->EndRecord();
+}
+
+void
+AppDelayTracer::LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay,
+                                                   int32_t hopCount)
+{
+  Record(app, seqno, "LastDelay", delay.ToDouble(Time::S), delay.ToDouble(Time::US), 1, hopCount);
 }
 
 void
 AppDelayTracer::FirstInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, uint32_t retxCount,
                                        int32_t hopCount)
 {
-  auto pConsumerApp = app->GetObject<ConsumerCbr>();
-  BOOST_ASSERT(pConsumerApp);
-  StringValue prefix;
-  pConsumerApp->GetAttribute("Prefix", prefix);
-  *m_os << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << app->GetId() << "\t"
-        << prefix.Get() << "\t"
-        << seqno << "\t"
-        << "FullDelay"
-        << "\t" << delay.ToDouble(Time::S) << "\t" << delay.ToDouble(Time::US) << "\t" << retxCount
-        << "\t" << hopCount << "\n";
+  Record(app, seqno, "FullDelay", delay.ToDouble(Time::S), delay.ToDouble(Time::US), retxCount,
+         hopCount);
 }
 
 void
 AppDelayTracer::LostInterest(Ptr<App> app, uint32_t seqno)
 {
-  auto pConsumerApp = app->GetObject<ConsumerCbr>();
-  BOOST_ASSERT(pConsumerApp);
-  StringValue prefix;
-  pConsumerApp->GetAttribute("Prefix", prefix);
-  *m_os << Simulator::Now().ToDouble(Time::S) << "\t" << m_node << "\t" << app->GetId() << "\t"
-        << prefix.Get() << "\t"
-        << seqno << "\t"
-        << "Lost"
-        << "\t" << 0 << "\t" << 0 << "\t" << 0 << "\t" << 0 << "\n";
+  Record(app, seqno, "Lost", 0, 0, 0, 0);
 }
 
 } // namespace sat
@@ -22,6 +22,8 @@
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
+#include "trace-sink.hpp"
+
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 #include "ns3/nstime.h"
@@ -82,16 +84,14 @@ public:
    * @brief Helper method to install tracers on a specific simulation node
    *
    * @param nodes Nodes on which to install tracer
-   * @param outputStream Smart pointer to a stream
-   * @param averagingPeriod How often data will be written into the trace file (default, every half
-   *        second)
+   * @param sink Sink to which records are written, its header is not written by the tracer
    *
    * @returns a tuple of reference to output stream and list of tracers.
    *          !!! Attention !!! This tuple needs to be preserved for the lifetime of simulation,
    *          otherwise SEGFAULTs are inevitable
    */
   static Ptr<AppDelayTracer>
-  Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream);
+  Install(Ptr<Node> node, shared_ptr<TraceSink> sink);
 
   /**
    * @brief Explicit request to remove all statically created tracers
@@ -104,17 +104,17 @@ public:
 
   /**
    * @brief Trace constructor that attaches to all applications on the node using node's pointer
-   * @param os    reference to the output stream
+   * @param sink  sink of the records
    * @param node  pointer to the node
    */
-  AppDelayTracer(shared_ptr<std::ostream> os, Ptr<Node> node);
+  AppDelayTracer(shared_ptr<TraceSink> sink, Ptr<Node> node);
 
   /**
    * @brief Trace constructor that attaches to all applications on the node using node's name
-   * @param os        reference to the output stream
+   * @param sink      sink of the records
    * @param nodeName  name of the node registered using Names::Add
    */
-  AppDelayTracer(shared_ptr<std::ostream> os, const std::string& node);
+  AppDelayTracer(shared_ptr<TraceSink> sink, const std::string& node);
 
   /**
    * @brief Destructor
@@ -122,17 +122,19 @@ public:
   ~AppDelayTracer();
 
   /**
-   * @brief Print head of the trace (e.g., for post-processing)
-   *
-   * @param os reference to output stream
+   * @brief Columns of the trace (e.g., for post-processing)
    */
-  void
-  PrintHeader(std::ostream& os) const;
+  static const TraceSink::Columns&
+  GetColumns();
 
 private:
   void
   Connect();
 
+  void
+  Record(Ptr<App> app, uint32_t seqno, const std::string& type, double delayS, double delayUS,
+         uint32_t retxCount, int32_t hopCount);
+
   void
   LastRetransmittedInterestDataDelay(Ptr<App> app, uint32_t seqno, Time delay, int32_t hopCount);
 
@@ -147,7 +149,7 @@ private:
   std::string m_node;
   Ptr<Node> m_nodePtr;
 
-  shared_ptr<std::ostream> m_os;
+  shared_ptr<TraceSink> m_sink;
 };
 
 } // namespace sat
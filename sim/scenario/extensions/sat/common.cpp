@@ -7,22 +7,30 @@
 
 #include "common.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <fstream>
 
 #include "ns3/log.h"
 #include "ns3/point-to-point-channel.h"
-#include "ns3/point-to-point-helper.h"
+#include "ns3/channel-list.h"
+#include "ns3/drop-tail-queue.h"
 
 #include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/ndnSIM/helper/ndn-fib-helper.hpp"
+#include "ns3/ndnSIM/helper/ndn-network-region-table-helper.hpp"
 #include "ns3/ndnSIM/NFD/daemon/face/generic-link-service.hpp"
 #include "ns3/ndnSIM/NFD/daemon/fw/strategy.hpp"
 
 #include "../kite/apps/producer/producer-app.hpp"
 
 #include "user-link-transport.hpp"
+#include "user-link-channel.hpp"
 #include "handover-manager.hpp"
+#include "trace-sink.hpp"
+#include "grid-strategy.hpp"
+#include "partition.hpp"
 #include "apps/consumer/consumer.hpp"
 #include "apps/consumer/consumer-cbr.hpp"
 
@@ -42,25 +50,50 @@ string
 constructFaceUri(Ptr<NetDevice> netDevice);
 
 std::shared_ptr<nfd::Face>
-createAndRegisterFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device);
+createAndRegisterFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device, FibUpdateTransaction& fibUpdates);
 
 void
-AttachPrefix(satellite& sat, station& station);
+AttachPrefix(satellite& sat, station& station, FibUpdateTransaction& fibUpdates);
 
 void
-DetachPrefix(station& station, satellite& sat);
+DetachPrefix(station& station, satellite& sat, Ptr<PointToPointNetDevice> satDevice, FibUpdateTransaction& fibUpdates);
+
+Ptr<PointToPointNetDevice>
+TakeUserLinkDevice(Ptr<Node> node);
+
+Ptr<PointToPointNetDevice>
+CreateUserLinkDevice(Ptr<Node> node);
+
+void
+ApplyRoutes(station& producer, const stationPair& stPair, const route& r, vector<satellite>& satellites,
+            FibUpdateTransaction& fibUpdates);
+
+void
+RemoveRoutes(station& producer, const stationPair& stPair, const route& r, vector<satellite>& satellites,
+             FibUpdateTransaction& fibUpdates);
 
 void
-ApplyRoutes(vector<string> prefixes, vector<string> links, map<string, satellite>& satellites);
+UpdateRoutes(const vector<string>& prefixes, const routeUpdate& update, vector<satellite>& satellites,
+             FibUpdateTransaction& fibUpdates);
 
 void
-RemoveRoutes(vector<string> prefixes, vector<string> links, map<string, satellite>& satellites);
+Attach(station& station, size_t attIdx, vector<satellite>& satellites, Time period,
+       FibUpdateTransaction& fibUpdates);
 
 void
-UpdateRoutes(vector<string> prefixes, map<string, vector<pair<string, string>>>& routes, map<string, satellite>& satellites);
+PrepareHandover(station& station, size_t lastAttIdx, vector<satellite>& satellites);
 
 void
-ShimResend(Ptr<Node> stationNode, string tunnelId);
+SetGridDestinations(const station& producer, vector<station>& stations, const vector<satellite>& satellites);
+
+void
+ShimResend(Ptr<Node> stationNode, LinkId tunnelId);
+
+void
+SetUserLinkDelay(station& station, int curTime);
+
+void
+SetIslMetric(Ptr<PointToPointChannel> channel, uint32_t delay);
 
 // public
 
@@ -119,22 +152,85 @@ split(string s, string delimiter) {
   return res;
 }
 
+vector<stationPair>
+ReadTrafficMatrix(const string& filename, const NodeRegistry& registry, size_t maxPairs)
+{
+  vector<stationPair> pairs;
+  map<string, vector<string>> pairsCsv = readCsv(filename);
+  if (pairsCsv.empty()) {
+    NS_LOG_ERROR("Cannot read station pairs from " << filename);
+    return pairs;
+  }
+
+  auto& consumers = pairsCsv["Consumer"];
+  auto& producers = pairsCsv["Producer"];
+  auto frequencies = pairsCsv.find("Frequency");
+  for (size_t row = 0; row < consumers.size() && row < producers.size(); row++) {
+    if (maxPairs > 0 && pairs.size() == maxPairs) {
+      break;
+    }
+    int consumerIdx = registry.FindStation(consumers[row]);
+    int producerIdx = registry.FindStation(producers[row]);
+    if (consumerIdx < 0 || producerIdx < 0 || consumerIdx == producerIdx) {
+      NS_LOG_WARN("Skip pair " << consumers[row] << " " << producers[row]);
+      continue;
+    }
+    stationPair stPair;
+    stPair.consumer = consumerIdx;
+    stPair.producer = producerIdx;
+    if (frequencies != pairsCsv.end() && row < frequencies->second.size()) {
+      stPair.frequency = frequencies->second[row];
+    }
+    pairs.push_back(stPair);
+  }
+
+  NS_LOG_INFO("Read " << pairs.size() << " station pairs from " << filename);
+  return pairs;
+}
+
 void
 ShowShimOverhead(string path)
 {
-  std::ofstream os;
-  os.open(path.c_str(), std::ios_base::out | std::ios_base::trunc);
-  // if (!os->is_open()) {
-  //   NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-  //   return;
-  // }
-
-  os << "Node\tInReq\tOutReq\tInAck\tOutAck\tInPayload\tOutPayload\n";
+  static const TraceSink::Columns columns = {
+    {"Node", TraceSink::STRING},
+    {"InReq", TraceSink::INTEGER},
+    {"OutReq", TraceSink::INTEGER},
+    {"InAck", TraceSink::INTEGER},
+    {"OutAck", TraceSink::INTEGER},
+    {"InPayload", TraceSink::INTEGER},
+    {"OutPayload", TraceSink::INTEGER},
+    {"OverflowDrops", TraceSink::INTEGER},
+    {"ExpiryDrops", TraceSink::INTEGER},
+    {"PeakBufferedBytes", TraceSink::INTEGER},
+    {"Flushes", TraceSink::INTEGER},
+    {"MaxFlushLatency(ms)", TraceSink::INTEGER},
+    {"MeanFlushLatency(ms)", TraceSink::REAL},
+  };
+  shared_ptr<TraceSink> sink = TraceSink::Open(path, columns);
+  if (sink == nullptr) {
+    return;
+  }
+
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (!IsLocalNode(*node)) { // counted by the rank simulating it
+      continue;
+    }
     auto handoverManager = (*node)->GetObject<HandoverManager>();
-    os << Names::FindName(*node) << "\t" << handoverManager->m_inReqs << "\t" << handoverManager->m_outReqs << "\t" << handoverManager->m_inAcks << "\t" << handoverManager->m_outAcks << "\t" << handoverManager->m_inPayloads << "\t" << handoverManager->m_outPayloads << "\n";
+    sink->AddString(Names::FindName(*node));
+    sink->AddInteger(handoverManager->m_inReqs);
+    sink->AddInteger(handoverManager->m_outReqs);
+    sink->AddInteger(handoverManager->m_inAcks);
+    sink->AddInteger(handoverManager->m_outAcks);
+    sink->AddInteger(handoverManager->m_inPayloads);
+    sink->AddInteger(handoverManager->m_outPayloads);
+    sink->AddInteger(handoverManager->m_overflowDrops);
+    sink->AddInteger(handoverManager->m_expiryDrops);
+    sink->AddInteger(handoverManager->m_peakBufferedBytes);
+    sink->AddInteger(handoverManager->m_flushes);
+    sink->AddInteger(handoverManager->m_maxFlushLatency.GetMilliSeconds());
+    sink->AddReal(handoverManager->m_flushes > 0 ? handoverManager->m_totalFlushLatency.GetMilliSeconds() / static_cast<double>(handoverManager->m_flushes) : 0);
+    sink->EndRecord();
   }
-  os.close();
 }
 
 shared_ptr<::nfd::face::Face>
@@ -176,299 +272,233 @@ SatPointToPointNetDeviceCallback(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDev
 }
 
 void
-Update(UpdateParams params, map<string, satellite>* pSatellites, map<string, station>* pStations,
-       map<pair<string, string>, vector<pair<int, vector<string>>>>* pRoutes,
-       map<string, vector<pair<int, map<string, vector<pair<string, string>>>>>>* pProducerRoutes)
+BuildHandoverQueue(UpdateParams params, NodeRegistry* pRegistry, vector<stationPair>* pPairs,
+                   vector<producerRoutes>* pProducerRoutes, HandoverQueue* pQueue)
 {
-  NS_LOG_INFO("Update: " << params.curTime << "min");
-  auto interval = params.interval;
-  auto curTime = params.curTime;
-  params.curTime += interval;
+  auto& stations = pRegistry->stations;
+  auto& events = pQueue->events;
+  Time start = Minutes(params.curTime);
+  pQueue->period = MilliSeconds(params.period);
 
-  auto& satellites = *pSatellites;
-  auto& stations = *pStations;
+  auto addEvent = [&] (Time time, handoverEvent::Type type, size_t owner, size_t idx) {
+    events.push_back(handoverEvent{std::max(time, start), type, owner, idx});
+  };
 
-  for (auto& item : stations) { // traverse active stations
-    auto& station = item.second;
+  for (size_t stIdx = 0; stIdx < stations.size(); stIdx++) {
+    auto& station = stations[stIdx];
     if (!station.isHost) {
       continue;
     }
-
-    if (station.curAttachmentIdx >= station.attachments.size()) {
-      continue;
-    }
-
-    string oldId = "";
-    if (station.handover) {
-      if (station.p2pDevice) { // attached to a satellite the last time
-        auto oldStFace = station.node->GetObject<L3Protocol>()->getFaceByNetDevice(station.p2pDevice);
-        BOOST_ASSERT(oldStFace);
-
-        // store previous user link id
-        oldId = ((UserLinkTransport*)(oldStFace->getTransport()))->m_id;
-
-        // remove faces for the last last user link
-        // BOOST_ASSERT(station.p2pDevice->GetChannel()->GetNDevices() == 2);
-        // auto oldSatDevice = station.p2pDevice->GetChannel()->GetDevice(0);
-        // if (oldSatDevice == station.p2pDevice) {
-        //   oldSatDevice = station.p2pDevice->GetChannel()->GetDevice(1);
-        // }
-        // BOOST_ASSERT(oldSatDevice);
-        // auto oldSatFace = oldSatDevice->GetNode()->GetObject<L3Protocol>()->getFaceByNetDevice(oldSatDevice);
-        // BOOST_ASSERT(oldSatFace);
-        // oldStFace->close();
-        // oldSatFace->close();
-
-        // remove previous local routes
-        auto lastSatName = station.attachments[station.lastAttachmentIdx].second;
-        auto& oldSat = satellites[lastSatName];
-        DetachPrefix(station, oldSat);
-
-        // finally reset p2p device
-        station.p2pDevice = nullptr;
-        oldSat.p2pDevice = nullptr;
+    int lastSatIdx = -1;
+    size_t lastIdx = 0;
+    for (size_t i = 0; i < station.attachments.size(); i++) {
+      auto& att = station.attachments[i];
+      if (att.second == lastSatIdx) {
+        continue; // same satellite, or still no satellite within range
       }
+      Time time = Minutes(att.first);
+      addEvent(time, handoverEvent::ATTACH, stIdx, i);
+      if (lastSatIdx >= 0 && att.second >= 0) {
+        addEvent(time - pQueue->period, handoverEvent::PREPARE, stIdx, lastIdx);
+      }
+      lastSatIdx = att.second;
+      lastIdx = i;
     }
+  }
 
-    auto curSatName = station.attachments[station.curAttachmentIdx].second;
-    if (curSatName == "-") { // no sat within range
-      NS_LOG_INFO("No sat within range for " << station.name);
-    }
-    else if (!station.handover && curTime > 0) {
-      NS_LOG_INFO("Same sat for " << station.name);
+  for (size_t pairIdx = 0; pairIdx < pPairs->size(); pairIdx++) {
+    auto& stPair = (*pPairs)[pairIdx];
+    stPair.curIdx = stPair.routes.size();
+    for (size_t i = 0; i < stPair.routes.size(); i++) {
+      addEvent(Minutes(stPair.routes[i].time), handoverEvent::PAIR_ROUTES, pairIdx, i);
     }
-    else {
-      auto& sat = satellites[curSatName];
-
-      // TODO: update user link delay
-
-      // TODO: assert no active p2p user link
-
-      // create new p2p link, and store devices
-      PointToPointHelper p2pHelper;
-      auto devices = p2pHelper.Install(station.node, sat.node);
-      station.p2pDevice = devices.Get(0)->GetObject<PointToPointNetDevice>();
-      sat.p2pDevice = devices.Get(1)->GetObject<PointToPointNetDevice>();
-      NS_LOG_INFO("Connect " << station.name << " " << station.node->GetId() << " to " << sat.name << " " << sat.node->GetId());
-    
-      // update NDN faces, install default routes
-      NS_LOG_INFO("Update NDN faces on " << station.name);
-      createAndRegisterFace(station.node, station.node->GetObject<L3Protocol>(), station.p2pDevice);
-      NS_LOG_INFO("Update NDN faces on " << sat.name);
-      createAndRegisterFace(sat.node, sat.node->GetObject<L3Protocol>(), sat.p2pDevice);
-
-      stringstream ss;
-      ss << station.p2pDevice->GetAddress() << "-" << sat.p2pDevice->GetAddress();
-      string userLinkId = ss.str();
-      NS_LOG_INFO("Set user link ID to " << userLinkId << ", for " << station.name);
-      auto stFace = station.node->GetObject<L3Protocol>()->getFaceByNetDevice(station.p2pDevice);
-      ((UserLinkTransport*)(stFace->getTransport()))->m_isUserLink = true;
-      ((UserLinkTransport*)(stFace->getTransport()))->m_id = userLinkId;
-      station.node->GetObject<HandoverManager>()->AddUserLink(userLinkId, stFace->getId());
-
-      NS_LOG_INFO("Set user link ID to " << userLinkId << ", for " << sat.name);
-      auto satFace = sat.node->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice);
-      ((UserLinkTransport*)(sat.node->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice)->getTransport()))->m_isUserLink = true;
-      ((UserLinkTransport*)(sat.node->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice)->getTransport()))->m_id = userLinkId;
-      sat.node->GetObject<HandoverManager>()->AddUserLink(userLinkId, satFace->getId());
-
-      // attach prefix to access satellite by adding route to station
-      AttachPrefix(sat, station);
-
-      // send t-req if shim layer mechanisms are enabled and attachment changes
-      if (oldId == "") {
-        NS_LOG_INFO("No previous attachment, do not send req");
-      }
-      else if (station.role == "consumer" || station.role == "m_producer") {
-        NS_LOG_INFO("Mobile consumer or producer, send T-Req if shim layer mechanisms are enabled");
-        if (UserLinkTransport::m_doShim) {
-          NS_LOG_INFO("Broadcast req for " << oldId);
-          station.node->GetObject<HandoverManager>()->BroadcastReq(oldId, 0, nullptr);
-          if (station.role == "consumer") {
-            NS_LOG_INFO("Mobile consumer, schedule resend after T-Req timeout");
-            // schedule retransmit upon anticipation of failure (ISL delay uniformly set to 10ms), add 5ms for what?
-            Simulator::Schedule (MilliSeconds (HandoverManager::m_hopLimit*10*2+5), &ShimResend, station.node, oldId);
-          }
-        }
-        else {
-          NS_LOG_INFO("Shim layer mechanisms disabled, do not send req");
-        }
-      }
-
-      if (station.role == "m_producer") {
-        // send kite update everytime attachment changes
-        NS_LOG_INFO("Mobile producer, initiate KITE update");
-        ::ns3::ndn::kite::Producer* producerApp =
-          dynamic_cast<::ns3::ndn::kite::Producer*>(&(*(station.node)->GetApplication(0)));
-        // 1ms delay to ensure FIBs are up-to-date
-        Simulator::Schedule (Seconds (0.001), &::ns3::ndn::kite::Producer::OnAssociation, producerApp);
-      }
+  }
 
-      NS_LOG_INFO("Attached " << station.name << " to " << sat.name);
+  for (size_t routesIdx = 0; routesIdx < pProducerRoutes->size(); routesIdx++) {
+    auto& updates = (*pProducerRoutes)[routesIdx].updates;
+    for (size_t i = 0; i < updates.size(); i++) {
+      addEvent(Minutes(updates[i].time), handoverEvent::PRODUCER_ROUTES, routesIdx, i);
     }
   }
 
-  // update manual routes
-  for (auto& item : *pRoutes) {
-    if (item.second.empty()) {
-      NS_LOG_INFO("No more routes from " << item.first.first << " to " << item.first.second);
-      continue;
-    }
-    auto producerSt = stations[item.first.second];
-    if (item.second[0].first == 0) {
-      // the first time, only add routes
-      item.second[0].first = -1; // mark
-      ApplyRoutes(producerSt.prefixes, item.second[0].second, satellites);
-      NS_LOG_INFO("Added initial routes from " << item.first.first << " to " << item.first.second);
-    }
-    else if (item.second.size() >= 2) {
-      // determine latest route, clear last route
-      if (curTime <= item.second[0].first) { // not the time to update routes yet
-        NS_LOG_INFO("Same routes (not yet) from " << item.first.first << " to " << item.first.second);
-        continue;
-      }
-      size_t curIdx = 1;
-      auto nextTime = item.second[1].first;
-      while ((curTime > nextTime) && (curIdx < item.second.size())) {
-        curIdx++;
-        nextTime = item.second[curIdx].first;
-      }
-      if (curIdx >= item.second.size()) {
-        NS_LOG_INFO("No more routes (exhausted) from " << item.first.first << " to " << item.first.second);
-        item.second.clear();
-      }
-      else {
-        bool updateRoute = false;
-        if (curTime < nextTime && curIdx != 1) {
-          curIdx--;
-          updateRoute = true;
-          NS_LOG_INFO("Update routes (gap) from " << item.first.first << " to " << item.first.second);
-        }
-        else if (curTime == nextTime) {
-          updateRoute = true;
-          NS_LOG_INFO("Update routes (hit) from " << item.first.first << " to " << item.first.second);
-        }
-      
-        if (updateRoute) {
-          RemoveRoutes(producerSt.prefixes, item.second[0].second, satellites);
-          ApplyRoutes(producerSt.prefixes, item.second[curIdx].second, satellites);
-          // pop out stale routes
-          item.second.erase(item.second.begin(), item.second.begin()+curIdx-1);
-        }
-        else {
-          NS_LOG_INFO("Same routes (gap) from " << item.first.first << " to " << item.first.second);
-        }
+  // attachments are changed before routes at the same time, as with the former periodic update
+  std::stable_sort(events.begin(), events.end(), [] (const handoverEvent& a, const handoverEvent& b) {
+      return a.time < b.time || (a.time == b.time && a.type < b.type);
+    });
+  pQueue->headIdx = 0;
+
+  NS_LOG_INFO("Built " << events.size() << " handover events");
+}
+
+void
+Update(HandoverQueue* pQueue, NodeRegistry* pRegistry, vector<stationPair>* pPairs,
+       vector<producerRoutes>* pProducerRoutes)
+{
+  auto& events = pQueue->events;
+  auto& head = pQueue->headIdx;
+  Time now = Simulator::Now();
+  NS_LOG_INFO("Update: " << now.GetMinutes() << "min");
+
+  auto& satellites = pRegistry->satellites;
+  auto& stations = pRegistry->stations;
+
+  // route changes of this update are applied to the FIBs at once, see FibUpdateTransaction
+  FibUpdateTransaction fibUpdates;
+
+  for (; head < events.size() && events[head].time <= now; head++) {
+    auto& event = events[head];
+    switch (event.type) {
+    case handoverEvent::ATTACH:
+      Attach(stations[event.owner], event.idx, satellites, pQueue->period, fibUpdates);
+      SetGridDestinations(stations[event.owner], stations, satellites);
+      break;
+    case handoverEvent::PAIR_ROUTES: {
+      auto& stPair = (*pPairs)[event.owner];
+      auto& producerSt = stations[stPair.producer];
+      // the new route is counted first, so that hops it shares with the old one stay in the FIBs
+      ApplyRoutes(producerSt, stPair, stPair.routes[event.idx], satellites, fibUpdates);
+      if (stPair.curIdx < stPair.routes.size()) {
+        RemoveRoutes(producerSt, stPair, stPair.routes[stPair.curIdx], satellites, fibUpdates);
       }
+      stPair.curIdx = event.idx;
+      NS_LOG_INFO("Update routes from " << stations[stPair.consumer].name << " to " << producerSt.name);
+      break;
+    }
+    case handoverEvent::PRODUCER_ROUTES: {
+      auto& pRoutes = (*pProducerRoutes)[event.owner];
+      UpdateRoutes(stations[pRoutes.producer].prefixes, pRoutes.updates[event.idx], satellites, fibUpdates);
+      break;
     }
-    // clear station pairs with no new routes
-    if (item.second.size() < 2) {
-      item.second.clear();
+    case handoverEvent::PREPARE:
+      PrepareHandover(stations[event.owner], event.idx, satellites);
+      break;
     }
   }
 
-  for (auto& item : *pProducerRoutes) {
-    if (item.second.empty()) {
-      NS_LOG_INFO("No more routes from " << item.first);
-      continue;
+  NS_LOG_INFO("Apply " << fibUpdates.GetSize() << " FIB changes");
+  fibUpdates.Commit();
+
+  if (head < events.size()) {
+    Simulator::Schedule(events[head].time - now, &Update, pQueue, pRegistry, pPairs, pProducerRoutes);
+  }
+}
+
+void
+UpdateDelays(int curTime, LinkDelays* pDelays, NodeRegistry* pRegistry)
+{
+  // user link devices and their channels are pooled, so the count stays bounded by the peak number of links
+  NS_LOG_INFO("Update delays: " << curTime << "min, " << ChannelList::GetNChannels() << " channels");
+  auto& delays = *pDelays;
+  bool hasMore = false;
+  bool isIslUpdated = false;
+
+  // advance to the latest ISL delays, then apply them to all ISLs in one pass
+  if (delays.curIdx < delays.islDelays.size() && delays.islDelays[delays.curIdx].first <= curTime) {
+    while (delays.curIdx + 1 < delays.islDelays.size() && delays.islDelays[delays.curIdx + 1].first <= curTime) {
+      delays.curIdx++;
     }
-    auto station = stations[item.first];
-    size_t nextIdx = 0;
-    auto nextTime = item.second[nextIdx].first;
-    while (curTime > nextTime && nextIdx < item.second.size()) {
-      nextIdx++;
-      nextTime = item.second[nextIdx].first;
-    }
-    bool update = false;
-    if (curTime == nextTime) {
-      update = true;
-    }
-    else if (curTime < nextTime) {
-      if (nextIdx > 0) {
-        update = true;
-        nextIdx--;
+    auto& islDelays = delays.islDelays[delays.curIdx].second;
+    BOOST_ASSERT(islDelays.size() == delays.islChannels.size());
+    for (size_t i = 0; i < islDelays.size(); i++) {
+      delays.islChannels[i]->SetAttribute("Delay", TimeValue(MicroSeconds(islDelays[i])));
+      if (delays.routingHelper != nullptr) {
+        SetIslMetric(delays.islChannels[i], islDelays[i]);
       }
     }
-    else {
-      item.second.clear();
-    }
+    delays.curIdx++;
+    isIslUpdated = true;
+  }
+  if (delays.curIdx < delays.islDelays.size()) {
+    hasMore = true;
+  }
+
+  // only trees using ISLs whose delay changed are repaired, the first call calculates all of them
+  if (delays.routingHelper != nullptr && (isIslUpdated || delays.distancesMap.empty())) {
+    delays.routingHelper->UpdateRoutes(&delays.distancesMap);
+  }
 
-    if (update) {
-      UpdateRoutes(station.prefixes, item.second[nextIdx].second, satellites);
-      item.second.erase(item.second.begin(), item.second.begin()+nextIdx);
+  for (auto& station : pRegistry->stations) {
+    SetUserLinkDelay(station, curTime);
+    if (static_cast<size_t>(curTime + 1) < station.userLinkDelays.size()) {
+      hasMore = true;
     }
   }
 
-  // update attachments (do not actually update links) and schedule consumer transmission if handover occurs
-  curTime += interval; // predict the attachment at next update
-  for (auto& item : stations) {
-    NS_LOG_INFO("Update attachment for " << item.first);
-    auto& station = item.second;
-    if (!station.isHost) {
+  if (hasMore) {
+    Simulator::Schedule (Seconds (60), &UpdateDelays, curTime + 1, pDelays, pRegistry);
+  }
+}
+
+void
+InstallGridNeighbors(NodeRegistry* pRegistry, const string& prefix, const string& satTopPrefix)
+{
+  auto& satellites = pRegistry->satellites;
+
+  vector<nfd::fw::GridCoord> coords(satellites.size(), nfd::fw::GridCoord{-1, -1});
+  nfd::fw::GridCoord gridSize{0, 0};
+  map<uint32_t, size_t> satIdxByNodeId;
+  for (size_t i = 0; i < satellites.size(); i++) {
+    if (!nfd::fw::GridStrategy::parseSatName(satellites[i].name, coords[i])) {
+      NS_LOG_WARN("Satellite " << satellites[i].name << " is not named after its position in the grid");
+      coords[i] = nfd::fw::GridCoord{-1, -1};
       continue;
     }
+    gridSize.orbit = std::max(gridSize.orbit, coords[i].orbit + 1);
+    gridSize.sat = std::max(gridSize.sat, coords[i].sat + 1);
+    satIdxByNodeId[satellites[i].node->GetId()] = i;
+  }
 
-    if (curTime <= station.attachments[station.curAttachmentIdx].first || station.curAttachmentIdx >= station.attachments.size()) {
-      // no need to update attachment, either next handover is yet to happen, or there are no more handovers
-      station.handover = false;
+  size_t nInstalled = 0;
+  for (size_t i = 0; i < satellites.size(); i++) {
+    auto& sat = satellites[i];
+    if (coords[i].orbit < 0) {
       continue;
     }
-
-    auto nextTime = station.attachments[station.curAttachmentIdx].first;
-    auto lastAttachmentIdx = station.curAttachmentIdx;
-    while (curTime > nextTime) {
-      station.curAttachmentIdx++;
-      if (station.curAttachmentIdx >= station.attachments.size()) {
-        break;
-      }
-      nextTime = station.attachments[station.curAttachmentIdx].first;
+    auto ndn = sat.node->GetObject<L3Protocol>();
+    auto strategy = dynamic_cast<nfd::fw::GridStrategy*>(&ndn->getForwarder()->getStrategyChoice().findEffectiveStrategy(Name(prefix)));
+    if (strategy == nullptr) {
+      continue;
     }
+    strategy->setLocation(coords[i], gridSize);
 
-    if (curTime < nextTime) {
-      // attachment at curAttachmentIdx-1
-      station.curAttachmentIdx--;
-      if (station.curAttachmentIdx != lastAttachmentIdx) {
-        // handover happens
-        station.lastAttachmentIdx = lastAttachmentIdx;
-        station.handover = true;
+    // ISLs are the only point-to-point devices at install time, user link devices are created on attachment
+    for (uint32_t d = 0; d < sat.node->GetNDevices(); d++) {
+      auto device = DynamicCast<PointToPointNetDevice>(sat.node->GetDevice(d));
+      if (device == nullptr || device->GetChannel() == nullptr) {
+        continue;
       }
-      else {
-        station.handover = false;
+      auto channel = device->GetChannel();
+      auto remoteNode = channel->GetDevice(channel->GetDevice(0) == device ? 1 : 0)->GetNode();
+      auto remote = satIdxByNodeId.find(remoteNode->GetId());
+      auto face = ndn->getFaceByNetDevice(device);
+      if (remote == satIdxByNodeId.end() || face == nullptr) {
+        continue;
       }
-    }
-    else if (curTime == nextTime) {
-      // attachment at curAttachmentIdx
-      station.lastAttachmentIdx = lastAttachmentIdx;
-      station.handover = true;
-    }
-    else {
-      station.handover = false;
-    }
-
-    if (station.handover) {
-      auto curSatName = station.attachments[station.curAttachmentIdx].second;
-      auto lastSatName = station.attachments[station.lastAttachmentIdx].second;
-      NS_LOG_INFO("Handover will happen for " << station.name << ", from " << lastSatName << " to " << curSatName);
-      if ((curSatName != "-") && (lastSatName != "-")) {
-        if (station.role == "consumer") {
-          Simulator::Schedule (MilliSeconds (interval*60*1000-params.period), &ConsumerCbr::Resume, (ConsumerCbr *)&(*(station.node->GetApplication(0))));
-          Simulator::Schedule (MilliSeconds (interval*60*1000+params.period), &ConsumerCbr::Pause, (ConsumerCbr *)&(*(station.node->GetApplication(0))));
-
-          // update last sat prefix
-          Name topPrefix("/sat");
-          auto& strategy = station.node->GetObject<L3Protocol>()->getForwarder()->getStrategyChoice().findEffectiveStrategy(topPrefix);
-          strategy.m_lastSatPrefix = Name(satellites[lastSatName].satPrefix);
-        }
-        else if (station.role == "m_producer") {
-          // schedule a KITE update immediately to allow the scheduled consumer Interest to reach the previous access satellite
-          ::ns3::ndn::kite::Producer* producerApp =
-            dynamic_cast<::ns3::ndn::kite::Producer*>(&(*(station.node)->GetApplication(0)));
-          Simulator::Schedule (Seconds (0.001), &::ns3::ndn::kite::Producer::OnAssociation, producerApp);
-        }
+      auto& remoteCoord = coords[remote->second];
+      if (remoteCoord.sat == coords[i].sat && remoteCoord.orbit == (coords[i].orbit + 1) % gridSize.orbit) {
+        strategy->setNeighbor(nfd::fw::GridStrategy::ORBIT_NEXT, face->getId());
+      }
+      else if (remoteCoord.sat == coords[i].sat && (remoteCoord.orbit + 1) % gridSize.orbit == coords[i].orbit) {
+        strategy->setNeighbor(nfd::fw::GridStrategy::ORBIT_PREV, face->getId());
+      }
+      else if (remoteCoord.orbit == coords[i].orbit && remoteCoord.sat == (coords[i].sat + 1) % gridSize.sat) {
+        strategy->setNeighbor(nfd::fw::GridStrategy::SAT_NEXT, face->getId());
+      }
+      else if (remoteCoord.orbit == coords[i].orbit && (remoteCoord.sat + 1) % gridSize.sat == coords[i].sat) {
+        strategy->setNeighbor(nfd::fw::GridStrategy::SAT_PREV, face->getId());
+      }
+      else {
+        NS_LOG_WARN("ISL between " << sat.name << " and " << satellites[remote->second].name << " is not on the grid");
       }
     }
+
+    sat.satPrefix = satTopPrefix + "/" + sat.name;
+    NetworkRegionTableHelper::AddRegionName(sat.node, sat.satPrefix);
+    nInstalled++;
   }
 
-  Simulator::Schedule (Seconds (interval*60), &Update, params, pSatellites, pStations, pRoutes, pProducerRoutes);
+  NS_LOG_INFO("Installed grid neighbors on " << nInstalled << " satellites, grid of "
+              << gridSize.orbit << " orbits x " << gridSize.sat << " satellites");
 }
 
 // private
@@ -486,15 +516,15 @@ constructFaceUri(Ptr<NetDevice> netDevice)
 }
 
 std::shared_ptr<nfd::Face>
-createAndRegisterFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device)
+createAndRegisterFace(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device, FibUpdateTransaction& fibUpdates)
 {
   std::shared_ptr<nfd::Face> face = SatPointToPointNetDeviceCallback(node, ndn, device);
-  FibHelper::AddRoute(node, "/", face, std::numeric_limits<int32_t>::max());
+  fibUpdates.AddRoute(node, "/", face, std::numeric_limits<int32_t>::max());
   return face;
 }
 
 void
-AttachPrefix(satellite& sat, station& station)
+AttachPrefix(satellite& sat, station& station, FibUpdateTransaction& fibUpdates)
 {
   auto satN = sat.node;
   auto stationN = station.node;
@@ -505,7 +535,7 @@ AttachPrefix(satellite& sat, station& station)
     for (auto prefix : prefixList) {
       NS_LOG_INFO("-prefix: " << prefix);
       // add route for station prefix
-      FibHelper::AddRoute(satN, prefix, satN->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice), 1);
+      fibUpdates.AddRoute(satN, prefix, satN->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice), 1);
     }
   }
   else {
@@ -514,77 +544,288 @@ AttachPrefix(satellite& sat, station& station)
 }
 
 void
-DetachPrefix(station& station, satellite& sat) {
+DetachPrefix(station& station, satellite& sat, Ptr<PointToPointNetDevice> satDevice, FibUpdateTransaction& fibUpdates) {
   auto stFace = station.node->GetObject<L3Protocol>()->getFaceByNetDevice(station.p2pDevice);
-  ((UserLinkTransport*)(stFace->getTransport()))->m_isGone = true; // mark gone
-  FibHelper::RemoveRoute(station.node, Name("/"), stFace->getId());
+  ((UserLinkTransport*)(stFace->getTransport()))->MarkGone();
+  fibUpdates.RemoveRoute(station.node, Name("/"), stFace);
 
-  auto satFace = sat.node->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice);
-  ((UserLinkTransport*)(satFace->getTransport()))->m_isGone = true; // mark gone
-  FibHelper::RemoveRoute(sat.node, Name("/"), satFace->getId());
+  auto satFace = sat.node->GetObject<L3Protocol>()->getFaceByNetDevice(satDevice);
+  ((UserLinkTransport*)(satFace->getTransport()))->MarkGone();
+  fibUpdates.RemoveRoute(sat.node, Name("/"), satFace);
 
   // remove local route to station
   auto& prefixList = station.prefixes;
   if (prefixList.size() > 0) {
     for (auto prefix : prefixList) {
-      FibHelper::RemoveRoute(sat.node, prefix, satFace->getId());
+      fibUpdates.RemoveRoute(sat.node, prefix, satFace);
     }
     NS_LOG_INFO("Removed sat to station route, node " << sat.node->GetId() << ", sat name: " << sat.name << ", station name: " << station.name);
   }
 }
 
 void
-ApplyRoutes(vector<string> prefixes, vector<string> links, map<string, satellite>& satellites)
+ApplyRoutes(station& producer, const stationPair& stPair, const route& r, vector<satellite>& satellites,
+            FibUpdateTransaction& fibUpdates)
 {
-  BOOST_ASSERT(links.size() > 1);
-  for (size_t i = 1; i < links.size(); i++) {
-    auto node1 = satellites[links[i-1]].node;
-    auto node2 = satellites[links[i]].node;
-    for (auto prefix : prefixes) {
-      FibHelper::AddRoute(node1, prefix, node2, std::numeric_limits<int32_t>::max());
-      NS_LOG_INFO("Apply route for " << prefix << " from " << links[i-1] << " " << node1->GetId() << " to " << links[i] << " " << node2->GetId());
+  BOOST_ASSERT(r.hopsEnd - r.hopsBegin > 1);
+  for (size_t i = r.hopsBegin + 1; i < r.hopsEnd; i++) {
+    // routes of pairs with the same producer share the FIB entries of the hops they have in common
+    if (producer.hopRefs[std::make_pair(stPair.hops[i-1], stPair.hops[i])]++ > 0) {
+      continue;
+    }
+    auto& sat1 = satellites[stPair.hops[i-1]];
+    auto& sat2 = satellites[stPair.hops[i]];
+    for (auto& prefix : producer.prefixes) {
+      fibUpdates.AddRoute(sat1.node, prefix, sat2.node, std::numeric_limits<int32_t>::max());
+      NS_LOG_INFO("Apply route for " << prefix << " from " << sat1.name << " " << sat1.node->GetId() << " to " << sat2.name << " " << sat2.node->GetId());
     }
   }
 }
 
 void
-RemoveRoutes(vector<string> prefixes, vector<string> links, map<string, satellite>& satellites)
+RemoveRoutes(station& producer, const stationPair& stPair, const route& r, vector<satellite>& satellites,
+             FibUpdateTransaction& fibUpdates)
 {
-  BOOST_ASSERT(links.size() > 1);
-  for (size_t i = 1; i < links.size(); i++) {
-    auto node1 = satellites[links[i-1]].node;
-    auto node2 = satellites[links[i]].node;
-    for (auto prefix : prefixes) {
-      FibHelper::RemoveRoute(node1, prefix, node2);
-      NS_LOG_INFO("Remove route for " << prefix << " from " << links[i-1] << " to " << links[i]);
+  BOOST_ASSERT(r.hopsEnd - r.hopsBegin > 1);
+  for (size_t i = r.hopsBegin + 1; i < r.hopsEnd; i++) {
+    auto hopRef = producer.hopRefs.find(std::make_pair(stPair.hops[i-1], stPair.hops[i]));
+    BOOST_ASSERT(hopRef != producer.hopRefs.end() && hopRef->second > 0);
+    if (--hopRef->second > 0) {
+      continue;
+    }
+    producer.hopRefs.erase(hopRef);
+    auto& sat1 = satellites[stPair.hops[i-1]];
+    auto& sat2 = satellites[stPair.hops[i]];
+    for (auto& prefix : producer.prefixes) {
+      fibUpdates.RemoveRoute(sat1.node, prefix, sat2.node);
+      NS_LOG_INFO("Remove route for " << prefix << " from " << sat1.name << " to " << sat2.name);
     }
   }
 }
 
 void
-UpdateRoutes(vector<string> prefixes, map<string, vector<pair<string, string>>>& routes, map<string, satellite>& satellites)
+UpdateRoutes(const vector<string>& prefixes, const routeUpdate& update, vector<satellite>& satellites,
+             FibUpdateTransaction& fibUpdates)
 {
-  for (auto& item : routes["add"]) {
-    auto node1 = satellites[item.first].node;
-    auto node2 = satellites[item.second].node;
-    for (auto prefix : prefixes) {
-      FibHelper::AddRoute(node1, prefix, node2, std::numeric_limits<int32_t>::max());
-      NS_LOG_INFO("Apply route for " << prefix << " from " << item.first << " " << node1->GetId() << " to " << item.second << " " << node2->GetId());
+  for (auto& item : update.add) {
+    auto& sat1 = satellites[item.first];
+    auto& sat2 = satellites[item.second];
+    for (auto& prefix : prefixes) {
+      fibUpdates.AddRoute(sat1.node, prefix, sat2.node, std::numeric_limits<int32_t>::max());
+      NS_LOG_INFO("Apply route for " << prefix << " from " << sat1.name << " " << sat1.node->GetId() << " to " << sat2.name << " " << sat2.node->GetId());
     }
   }
 
-  for (auto& item : routes["remove"]) {
-    auto node1 = satellites[item.first].node;
-    auto node2 = satellites[item.second].node;
-    for (auto prefix : prefixes) {
-      FibHelper::RemoveRoute(node1, prefix, node2);
-      NS_LOG_INFO("Remove route for " << prefix << " from " << item.first << " " << node1->GetId() << " to " << item.second << " " << node2->GetId());
+  for (auto& item : update.remove) {
+    auto& sat1 = satellites[item.first];
+    auto& sat2 = satellites[item.second];
+    for (auto& prefix : prefixes) {
+      fibUpdates.RemoveRoute(sat1.node, prefix, sat2.node);
+      NS_LOG_INFO("Remove route for " << prefix << " from " << sat1.name << " " << sat1.node->GetId() << " to " << sat2.name << " " << sat2.node->GetId());
+    }
+  }
+}
+
+void
+Attach(station& station, size_t attIdx, vector<satellite>& satellites, Time period,
+       FibUpdateTransaction& fibUpdates)
+{
+  LinkId oldId = INVALID_LINK_ID;
+  if (station.p2pDevice) { // attached to a satellite the last time
+    auto oldStFace = station.node->GetObject<L3Protocol>()->getFaceByNetDevice(station.p2pDevice);
+    BOOST_ASSERT(oldStFace);
+
+    // store previous user link id
+    oldId = ((UserLinkTransport*)(oldStFace->getTransport()))->m_id;
+
+    // remove previous local routes, the satellite end is found through the channel as other
+    // stations may have attached to the same satellite since
+    auto lastSatIdx = station.attachments[station.curAttachmentIdx].second;
+    auto& oldSat = satellites[lastSatIdx];
+    auto channel = DynamicCast<UserLinkChannel>(station.p2pDevice->GetChannel());
+    auto oldSatDevice = DynamicCast<PointToPointNetDevice>(channel->GetDevice(1));
+    DetachPrefix(station, oldSat, oldSatDevice, fibUpdates);
+    channel->Unbind();
+
+    // faces of the old user link are kept for tunnelled packets, then closed and their devices pooled
+    station.node->GetObject<HandoverManager>()->RetireUserLink(oldId);
+    oldSat.node->GetObject<HandoverManager>()->RetireUserLink(oldId);
+
+    station.p2pDevice = nullptr;
+    if (oldSat.p2pDevice == oldSatDevice) {
+      oldSat.p2pDevice = nullptr;
     }
   }
+  station.lastAttachmentIdx = station.curAttachmentIdx;
+  station.curAttachmentIdx = attIdx;
+
+  auto curSatIdx = station.attachments[attIdx].second;
+  if (curSatIdx < 0) { // no sat within range
+    NS_LOG_INFO("No sat within range for " << station.name);
+    return;
+  }
+
+  auto& sat = satellites[curSatIdx];
+
+  // bind devices of closed user links (or new ones) with a p2p link, and store devices
+  station.p2pDevice = TakeUserLinkDevice(station.node);
+  sat.p2pDevice = TakeUserLinkDevice(sat.node);
+  UserLinkChannel::Bind(DynamicCast<UserLinkChannel>(station.p2pDevice->GetChannel()),
+                        DynamicCast<UserLinkChannel>(sat.p2pDevice->GetChannel()));
+  SetUserLinkDelay(station, static_cast<int>(station.attachments[attIdx].first)); // later changes are applied by UpdateDelays
+  NS_LOG_INFO("Connect " << station.name << " " << station.node->GetId() << " to " << sat.name << " " << sat.node->GetId());
+
+  // update NDN faces, install default routes
+  NS_LOG_INFO("Update NDN faces on " << station.name);
+  createAndRegisterFace(station.node, station.node->GetObject<L3Protocol>(), station.p2pDevice, fibUpdates);
+  NS_LOG_INFO("Update NDN faces on " << sat.name);
+  createAndRegisterFace(sat.node, sat.node->GetObject<L3Protocol>(), sat.p2pDevice, fibUpdates);
+
+  LinkId userLinkId = HandoverManager::AllocateLinkId();
+  NS_LOG_INFO("Set user link ID to " << userLinkId << " (" << station.p2pDevice->GetAddress() << "-"
+              << sat.p2pDevice->GetAddress() << "), for " << station.name);
+  auto stFace = station.node->GetObject<L3Protocol>()->getFaceByNetDevice(station.p2pDevice);
+  ((UserLinkTransport*)(stFace->getTransport()))->m_isUserLink = true;
+  ((UserLinkTransport*)(stFace->getTransport()))->m_id = userLinkId;
+  station.node->GetObject<HandoverManager>()->AddUserLink(userLinkId, stFace->getId());
+
+  NS_LOG_INFO("Set user link ID to " << userLinkId << ", for " << sat.name);
+  auto satFace = sat.node->GetObject<L3Protocol>()->getFaceByNetDevice(sat.p2pDevice);
+  ((UserLinkTransport*)(satFace->getTransport()))->m_isUserLink = true;
+  ((UserLinkTransport*)(satFace->getTransport()))->m_id = userLinkId;
+  sat.node->GetObject<HandoverManager>()->AddUserLink(userLinkId, satFace->getId());
+
+  // attach prefix to access satellite by adding route to station
+  AttachPrefix(sat, station, fibUpdates);
+
+  // all ranks update links and faces alike, packets and apps are left to the rank of the station
+  if (!IsLocalNode(station.node)) {
+    NS_LOG_INFO("Attached " << station.name << " to " << sat.name << ", simulated by rank " << station.node->GetSystemId());
+    return;
+  }
+
+  // send t-req if shim layer mechanisms are enabled and attachment changes
+  if (oldId == INVALID_LINK_ID) {
+    NS_LOG_INFO("No previous attachment, do not send req");
+  }
+  else if (station.role == "consumer" || station.role == "m_producer") {
+    NS_LOG_INFO("Mobile consumer or producer, send T-Req if shim layer mechanisms are enabled");
+    if (UserLinkTransport::m_doShim) {
+      NS_LOG_INFO("Broadcast req for " << oldId);
+      station.node->GetObject<HandoverManager>()->BroadcastReq(oldId, 0, nullptr);
+      if (station.role == "consumer") {
+        NS_LOG_INFO("Mobile consumer, schedule resend after T-Req timeout");
+        // schedule retransmit upon anticipation of failure (ISL delay uniformly set to 10ms), add 5ms for what?
+        Simulator::Schedule (MilliSeconds (HandoverManager::m_hopLimit*10*2+5), &ShimResend, station.node, oldId);
+      }
+    }
+    else {
+      NS_LOG_INFO("Shim layer mechanisms disabled, do not send req");
+    }
+  }
+
+  if (oldId != INVALID_LINK_ID && station.role == "consumer") {
+    // end of the active period started by PrepareHandover, for the consumers of all pairs of the station
+    for (uint32_t i = 0; i < station.node->GetNApplications(); i++) {
+      auto consumerApp = DynamicCast<ConsumerCbr>(station.node->GetApplication(i));
+      if (consumerApp != nullptr) {
+        Simulator::Schedule (period, &ConsumerCbr::Pause, consumerApp);
+      }
+    }
+  }
+
+  if (station.role == "m_producer") {
+    // send kite update everytime attachment changes
+    NS_LOG_INFO("Mobile producer, initiate KITE update");
+    ::ns3::ndn::kite::Producer* producerApp =
+      dynamic_cast<::ns3::ndn::kite::Producer*>(&(*(station.node)->GetApplication(0)));
+    // 1ms delay to ensure FIBs are up-to-date
+    Simulator::Schedule (Seconds (0.001), &::ns3::ndn::kite::Producer::OnAssociation, producerApp);
+  }
+
+  NS_LOG_INFO("Attached " << station.name << " to " << sat.name);
 }
 
 void
-ShimResend(Ptr<Node> stationNode, string tunnelId)
+PrepareHandover(station& station, size_t lastAttIdx, vector<satellite>& satellites)
+{
+  auto lastSatIdx = station.attachments[lastAttIdx].second;
+  NS_LOG_INFO("Handover will happen for " << station.name << ", from " << satellites[lastSatIdx].name);
+  if (!IsLocalNode(station.node)) {
+    return;
+  }
+  if (station.role == "consumer") {
+    for (uint32_t i = 0; i < station.node->GetNApplications(); i++) {
+      auto consumerApp = DynamicCast<ConsumerCbr>(station.node->GetApplication(i));
+      if (consumerApp != nullptr) {
+        consumerApp->Resume();
+      }
+    }
+
+    // update last sat prefix
+    Name topPrefix("/sat");
+    auto& strategy = station.node->GetObject<L3Protocol>()->getForwarder()->getStrategyChoice().findEffectiveStrategy(topPrefix);
+    strategy.m_lastSatPrefix = Name(satellites[lastSatIdx].satPrefix);
+  }
+  else if (station.role == "m_producer") {
+    // schedule a KITE update immediately to allow the scheduled consumer Interest to reach the previous access satellite
+    ::ns3::ndn::kite::Producer* producerApp =
+      dynamic_cast<::ns3::ndn::kite::Producer*>(&(*(station.node)->GetApplication(0)));
+    Simulator::Schedule (Seconds (0.001), &::ns3::ndn::kite::Producer::OnAssociation, producerApp);
+  }
+}
+
+void
+SetGridDestinations(const station& producer, vector<station>& stations, const vector<satellite>& satellites)
+{
+  if (producer.consumerStIdxs.empty()) {
+    return;
+  }
+
+  // consumers using the orbit-grid strategy address Interests to the satellite the producer is attached to
+  auto satIdx = producer.attachments[producer.curAttachmentIdx].second;
+  Name satRegion = satIdx < 0 ? Name() : Name(satellites[satIdx].satPrefix);
+  for (auto consumerIdx : producer.consumerStIdxs) {
+    auto& consumer = stations[consumerIdx];
+    for (auto& prefix : producer.prefixes) {
+      auto& strategy = consumer.node->GetObject<L3Protocol>()->getForwarder()->getStrategyChoice().findEffectiveStrategy(Name(prefix));
+      auto gridStrategy = dynamic_cast<nfd::fw::GridStrategy*>(&strategy);
+      if (gridStrategy == nullptr) {
+        continue;
+      }
+      gridStrategy->setDestination(prefix, satRegion);
+      NS_LOG_INFO("Set destination of " << prefix << " to " << satRegion << " on " << consumer.name);
+    }
+  }
+}
+
+Ptr<PointToPointNetDevice>
+TakeUserLinkDevice(Ptr<Node> node)
+{
+  auto device = node->GetObject<HandoverManager>()->TakeFreeUserLinkDevice();
+  if (device == nullptr) {
+    device = CreateUserLinkDevice(node);
+  }
+  return device;
+}
+
+Ptr<PointToPointNetDevice>
+CreateUserLinkDevice(Ptr<Node> node)
+{
+  // attributes take the defaults set with Config::SetDefault, as devices of PointToPointHelper do
+  auto device = CreateObject<PointToPointNetDevice>();
+  device->SetAddress(Mac48Address::Allocate());
+  node->AddDevice(device);
+  device->SetQueue(CreateObject<DropTailQueue<Packet>>());
+  // the device keeps its channel, which is bound to the channel of the other end on each attachment
+  UserLinkChannel::Install(device);
+  NS_LOG_INFO("Created user link device " << device->GetAddress() << " on node " << node->GetId()
+              << ", " << ChannelList::GetNChannels() << " channels");
+  return device;
+}
+
+void
+ShimResend(Ptr<Node> stationNode, LinkId tunnelId)
 {
   auto handoverManager = stationNode->GetObject<HandoverManager>();
   if(!handoverManager->isInTib(tunnelId)) {
@@ -593,6 +834,36 @@ ShimResend(Ptr<Node> stationNode, string tunnelId)
   }
 }
 
+void
+SetUserLinkDelay(station& station, int curTime)
+{
+  if (station.p2pDevice == nullptr || station.userLinkDelays.empty()) {
+    return;
+  }
+  size_t epoch = std::min(static_cast<size_t>(curTime), station.userLinkDelays.size() - 1);
+  if (station.userLinkDelays[epoch] == 0) {
+    // not attached according to the delay table, keep the current delay
+    return;
+  }
+  auto channel = DynamicCast<UserLinkChannel>(station.p2pDevice->GetChannel());
+  NS_ASSERT(channel != nullptr);
+  channel->SetLinkDelay(MicroSeconds(station.userLinkDelays[epoch]));
+}
+
+void
+SetIslMetric(Ptr<PointToPointChannel> channel, uint32_t delay)
+{
+  // in units of 10us, so that metrics of ISLs (at most tens of milliseconds) fit the 16 bits routing uses
+  int32_t metric = std::max<int32_t>(1, delay / 10);
+  for (size_t d = 0; d < channel->GetNDevices(); d++) {
+    auto device = channel->GetDevice(d);
+    auto face = device->GetNode()->GetObject<L3Protocol>()->getFaceByNetDevice(device);
+    if (face != nullptr) {
+      face->setMetric(metric);
+    }
+  }
+}
+
 } // namespace sat
 } // namespace ndn
 } // namespace ns3
@@ -13,6 +13,9 @@
 #include "ns3/waypoint.h"
 
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
+
+#include "global-routing-helper.hpp"
 
 #include <string>
 #include <vector>
@@ -31,7 +34,7 @@ struct satellite {
   string name;
   Ptr<Node> node;
   string satPrefix;
-  Ptr<PointToPointNetDevice> p2pDevice;
+  Ptr<PointToPointNetDevice> p2pDevice; // device of the last attached station
   string rvPrefix;
   satellite()
     : p2pDevice(nullptr)
@@ -45,14 +48,15 @@ struct station {
   bool isHost;
   string role;
   vector<string> prefixes;
-  vector<string> consumerStNames;
+  vector<size_t> consumerStIdxs;
   vector<Ptr<Application>> consumerApps;
-  Ptr<PointToPointNetDevice> p2pDevice;
+  map<pair<uint32_t, uint32_t>, uint32_t> hopRefs; // (from, to) satellite indices => number of installed pair routes to this producer using the hop
+  Ptr<PointToPointNetDevice> p2pDevice; // user link device while attached, nullptr otherwise
   Ptr<PointToPointNetDevice> lastP2pDevice;
-  vector<pair<int, string>> attachments;
+  vector<pair<double, int>> attachments; // (time in minutes, satellite index), index is -1 if no satellite is within range
+  vector<uint32_t> userLinkDelays; // delay (us) of the user link at each epoch (minute), 0 if not attached
   size_t curAttachmentIdx;
   size_t lastAttachmentIdx;
-  bool handover;
   station()
     : isHost(false)
     , role("")
@@ -60,34 +64,194 @@ struct station {
     , lastP2pDevice(nullptr)
     , curAttachmentIdx(0)
     , lastAttachmentIdx(0)
-    , handover(false)
+  {
+  }
+};
+
+/**
+ * @brief Dense, index-addressed registry of satellites and stations
+ *
+ * Names are interned once at load time, all per-epoch state refers to nodes by index.
+ */
+struct NodeRegistry {
+  vector<satellite> satellites;
+  vector<station> stations;
+  map<string, size_t> satIndices; // only for lookups at load time
+  map<string, size_t> stIndices;
+
+  size_t
+  AddSatellite(const string& name, Ptr<Node> node)
+  {
+    satellites.push_back(satellite());
+    satellites.back().name = name;
+    satellites.back().node = node;
+    satIndices[name] = satellites.size() - 1;
+    return satellites.size() - 1;
+  }
+
+  size_t
+  AddStation(const string& name, Ptr<Node> node)
+  {
+    stations.push_back(station());
+    stations.back().name = name;
+    stations.back().node = node;
+    stIndices[name] = stations.size() - 1;
+    return stations.size() - 1;
+  }
+
+  int
+  FindSatellite(const string& name) const
+  {
+    auto it = satIndices.find(name);
+    return it == satIndices.end() ? -1 : static_cast<int>(it->second);
+  }
+
+  int
+  FindStation(const string& name) const
+  {
+    auto it = stIndices.find(name);
+    return it == stIndices.end() ? -1 : static_cast<int>(it->second);
+  }
+};
+
+struct route {
+  double time; // in minutes
+  size_t hopsBegin; // [hopsBegin, hopsEnd) in stationPair::hops
+  size_t hopsEnd;
+};
+
+struct stationPair {
+  size_t consumer; // station indices
+  size_t producer;
+  vector<uint32_t> hops; // satellite indices of all routes, contiguous
+  vector<route> routes;
+  size_t curIdx; // route currently installed, routes.size() if none
+  string frequency; // Interests per second of the consumer, empty for the default of the run
+  stationPair()
+    : consumer(0)
+    , producer(0)
+    , curIdx(0)
+  {
+  }
+};
+
+struct routeUpdate {
+  double time; // in minutes
+  vector<pair<size_t, size_t>> add; // (from, to) satellite indices
+  vector<pair<size_t, size_t>> remove;
+};
+
+struct producerRoutes {
+  size_t producer; // station index
+  vector<routeUpdate> updates;
+  producerRoutes()
+    : producer(0)
   {
   }
 };
 
 extern bool sameOrbit;
 struct UpdateParams {
-    int interval;
     int curTime; // in minutes
     int period; // in ms
 };
 
+/**
+ * @brief A change of attachment or routes, at the time given by the scenario
+ */
+struct handoverEvent {
+  enum Type {
+    ATTACH,          // station owner moves to attachment idx
+    PAIR_ROUTES,     // station pair owner switches to route idx
+    PRODUCER_ROUTES, // producer routes owner apply update idx
+    PREPARE          // period before station owner leaves attachment idx for another satellite
+  };
+  Time time;
+  Type type;
+  size_t owner;
+  size_t idx;
+};
+
+/**
+ * @brief All attachment and route changes of a run in time order, consumed by Update
+ *
+ * Events due at the same time are handled in one simulator event, so epochs without any change cost
+ * nothing and handovers happen at their exact times instead of on a polling grid.
+ */
+struct HandoverQueue {
+  vector<handoverEvent> events; // ordered by time, then type
+  size_t headIdx; // events before headIdx are handled
+  Time period; // consumers are active from period before to period after a handover
+  HandoverQueue()
+    : headIdx(0)
+  {
+  }
+};
+
+struct LinkDelays {
+  vector<Ptr<PointToPointChannel>> islChannels; // in the order of ISLs.csv
+  vector<pair<int, vector<uint32_t>>> islDelays; // delays (us) of all ISLs at each epoch (minute), in the order of islChannels
+  size_t curIdx;
+  GlobalRoutingHelper* routingHelper; // if set, ISL face metrics follow the delays and routes are repaired at each epoch
+  map<Ptr<Node>, boost::DistancesMap> distancesMap; // shortest path trees cached by routingHelper
+  LinkDelays()
+    : curIdx(0)
+    , routingHelper(nullptr)
+  {
+  }
+};
+
 map<string, vector<string>>
 readCsv(string filename);
 
 vector<string>
 split(string s, string delimiter);
 
+/**
+ * @brief Read the station pairs of a traffic matrix, as written by Leo.py (storeGtPairs)
+ *
+ * Columns are Consumer and Producer, an optional Frequency column gives the Interest frequency
+ * of each pair. Pairs of unknown stations are skipped, at most maxPairs pairs are read if not 0.
+ */
+vector<stationPair>
+ReadTrafficMatrix(const string& filename, const NodeRegistry& registry, size_t maxPairs = 0);
+
 void
 ShowShimOverhead(string path);
 
 shared_ptr<::nfd::face::Face>
 SatPointToPointNetDeviceCallback(Ptr<Node> node, Ptr<L3Protocol> ndn, Ptr<NetDevice> device);
 
+/**
+ * @brief Build the events of all host stations, station pairs and producer routes from params.curTime on
+ *
+ * Attachments to the same satellite as the previous one are not events, earlier changes are
+ * applied at params.curTime.
+ */
+void
+BuildHandoverQueue(UpdateParams params, NodeRegistry* pRegistry, vector<stationPair>* pPairs,
+                   vector<producerRoutes>* pProducerRoutes, HandoverQueue* pQueue);
+
+/**
+ * @brief Handle the events of pQueue that are due, then schedule itself at the time of the next one
+ */
+void
+Update(HandoverQueue* pQueue, NodeRegistry* pRegistry, vector<stationPair>* pPairs,
+       vector<producerRoutes>* pProducerRoutes);
+
+void
+UpdateDelays(int curTime, LinkDelays* pDelays, NodeRegistry* pRegistry);
+
+/**
+ * @brief Give the orbit-grid strategy of each satellite its position and the faces of its ISLs
+ *
+ * Positions are taken from the satellite names, see getSatId in Leo.py, and the grid size from the
+ * largest ones. Each satellite also gets satTopPrefix/<name> as satPrefix and network region, so
+ * that the forwarding hint is stripped when an Interest reaches it. Satellites whose strategy for
+ * prefix is not the orbit-grid strategy are left unchanged.
+ */
 void
-Update(UpdateParams params, map<string, satellite>* pSatellites, map<string, station>* pStations,
-       map<pair<string, string>, vector<pair<int, vector<string>>>>* pRoutes,
-       map<string, vector<pair<int, map<string, vector<pair<string, string>>>>>>* pProducerRoutes);
+InstallGridNeighbors(NodeRegistry* pRegistry, const string& prefix, const string& satTopPrefix);
 
 } // namespace sat
 } // namespace ndn
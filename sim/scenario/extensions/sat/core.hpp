@@ -2,11 +2,11 @@
 #define SAT_CORE_HPP
 
 #include "tlv.hpp"
+#include "link-id-map.hpp"
 
 #include "ns3/ndnSIM/ndn-cxx/encoding/block.hpp"
 #include "ns3/ndnSIM/ndn-cxx/encoding/block-helpers.hpp"
 
-#include <string>
 
 namespace ns3 {
 namespace ndn {
@@ -15,10 +15,6 @@ namespace core {
 
 using ::ndn::Block;
 using ::ndn::encoding::makeNonNegativeIntegerBlock;
-using ::ndn::encoding::makeStringBlock;
-using ::ndn::encoding::makeNonNegativeIntegerBlock;
-
-using std::string;
 
 enum PacketType {
     Type_LinkPayload,
@@ -30,14 +26,14 @@ class TunnelReq {
 public:
     static const uint64_t HOP_LIMIT = 2;
 
-    TunnelReq(string linkId)
+    TunnelReq(LinkId linkId)
         : m_linkId(linkId)
         , m_hopLimit(HOP_LIMIT)
         , m_wire(tlv::AdaptationPacket)
     {
     }
 
-    TunnelReq(string linkId, uint64_t hopLimit)
+    TunnelReq(LinkId linkId, uint64_t hopLimit)
         : m_linkId(linkId)
         , m_wire(tlv::AdaptationPacket)
     {
@@ -49,21 +45,21 @@ public:
     wireEncode()
     {
         m_wire.push_back(makeNonNegativeIntegerBlock(tlv::PacketType, core::Type_TunnelReq));
-        m_wire.push_back(makeStringBlock(tlv::LinkId, m_linkId));
+        m_wire.push_back(makeNonNegativeIntegerBlock(tlv::LinkId, m_linkId));
         m_wire.push_back(makeNonNegativeIntegerBlock(tlv::HopLimit, m_hopLimit));
         m_wire.encode();
         return m_wire;
     }
 
 private:
-    string m_linkId;
+    LinkId m_linkId;
     uint64_t m_hopLimit;
     Block m_wire;
 };
 
 class TunnelAck {
 public:
-    TunnelAck(string linkId)
+    TunnelAck(LinkId linkId)
         : m_linkId(linkId)
         , m_wire(tlv::AdaptationPacket)
     {
@@ -73,19 +69,19 @@ public:
     wireEncode()
     {
         m_wire.push_back(makeNonNegativeIntegerBlock(tlv::PacketType, core::Type_TunnelAck));
-        m_wire.push_back(makeStringBlock(tlv::LinkId, m_linkId));
+        m_wire.push_back(makeNonNegativeIntegerBlock(tlv::LinkId, m_linkId));
         m_wire.encode();
         return m_wire;
     }
 
 private:
-    string m_linkId;
+    LinkId m_linkId;
     Block m_wire;
 };
 
 class LinkPayload {
 public:
-    LinkPayload(string tunnelId, const Block& payload)
+    LinkPayload(LinkId tunnelId, const Block& payload)
         : m_tunnelId(tunnelId)
         , m_payload(payload)
         , m_wire(tlv::AdaptationPacket)
@@ -96,7 +92,7 @@ public:
     wireEncode()
     {
         m_wire.push_back(makeNonNegativeIntegerBlock(tlv::PacketType, core::Type_LinkPayload));
-        m_wire.push_back(makeStringBlock(tlv::TunnelId, m_tunnelId));
+        m_wire.push_back(makeNonNegativeIntegerBlock(tlv::TunnelId, m_tunnelId));
         Block payloadBlock(tlv::Payload);
         payloadBlock.push_back(m_payload);
         m_wire.push_back(payloadBlock);
@@ -105,7 +101,7 @@ public:
     }
 
 private:
-    string m_tunnelId;
+    LinkId m_tunnelId;
     Block m_payload;
     Block m_wire;
 };
@@ -26,6 +26,7 @@
 #include "global-routing-helper.hpp"
 
 #include "user-link-transport.hpp"
+#include "routing-graph.hpp"
 
 #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
 #include "ns3/ndnSIM/helper/ndn-fib-helper.hpp"
@@ -53,10 +54,12 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/foreach.hpp>
 #include <boost/concept/assert.hpp>
-#include <boost/graph/dijkstra_shortest_paths.hpp>
 
 #include <unordered_map>
 #include <cmath>
+#include <functional>
+#include <queue>
+#include <vector>
 
 NS_LOG_COMPONENT_DEFINE("ndn.sat.GlobalRoutingHelper");
 
@@ -225,152 +228,281 @@ GlobalRoutingHelper::AddOriginsForAll()
 void
 GlobalRoutingHelper::CalculateRoutes()
 {
-  /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
-   */
-
-  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
-  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
-
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  // Dijkstra from every node over a flat snapshot of the GlobalRouter incidencies, see RoutingGraph
+  RoutingGraph graph;
+  FibUpdateTransaction fibUpdates;
+
+  for (uint32_t source = 0; source < graph.GetNVertices(); source++) {
+    graph.ShortestPaths(source);
+
+    Ptr<Node> node = graph.GetNode(source);
+    NS_LOG_DEBUG("Reachability from Node: " << node->GetId() << ", name: " << Names::FindName(node));
+    for (uint32_t v = 0; v < graph.GetNVertices(); v++) {
+      int32_t firstHop = graph.GetFirstHop(v);
+      if (firstHop < 0) {
+        continue; // the source itself, or unreachable
+      }
+      for (const auto& prefix : graph.GetRouter(v)->GetLocalPrefixes()) {
+        NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *graph.GetFace(firstHop)
+                     << " with distance " << graph.GetDistance(v));
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
-      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
-      continue;
+        fibUpdates.AddRoute(node, *prefix, graph.GetFace(firstHop), graph.GetDistance(v));
+      }
     }
+  }
 
-    boost::DistancesMap distances;
-
-    dijkstra_shortest_paths(graph, source,
-                            // predecessor_map (boost::ref(predecessors))
-                            // .
-                            distance_map(boost::ref(distances))
-                              .distance_inf(boost::WeightInf)
-                              .distance_zero(boost::WeightZero)
-                              .distance_compare(boost::WeightCompare())
-                              .distance_combine(boost::WeightCombine()));
-
-    // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+  fibUpdates.Commit();
+}
 
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    std::shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
+void
+AddRoute(Ptr<Node> node, const Name& prefix, std::shared_ptr<nfd::Face> face, int32_t metric,
+         FibUpdateTransaction& fibUpdates)
+{
+  // routes have a single next hop, the previous one is removed when the transaction is committed,
+  // and the last route added for prefix within the transaction wins
+  fibUpdates.ReplaceRoute(node, prefix, face, metric);
+}
 
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId() << ", name: " << Names::FindName(source->GetObject<Node>()));
-    for (const auto& dist : distances) {
-      if (dist.first == source)
-        continue;
-      else {
-        // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-        if (std::get<0>(dist.second) == 0) {
-          // cout << " is unreachable" << endl;
-        }
-        else {
-          for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-            NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *std::get<0>(dist.second)
-                         << " with distance " << std::get<1>(dist.second) << " with delay "
-                         << std::get<2>(dist.second));
+GlobalRoutingHelper::RoutingEdges
+GlobalRoutingHelper::SnapshotEdges(const RoutingGraph& graph)
+{
+  RoutingEdges edges;
+  for (uint32_t v = 0; v < graph.GetNVertices(); v++) {
+    for (uint32_t e = graph.EdgesBegin(v); e < graph.EdgesEnd(v); e++) {
+      RoutingEdge edge = {graph.GetRouter(v), graph.GetRouter(graph.GetTarget(e)), graph.GetFace(e),
+                          graph.GetMetric(e)};
+      edges[std::make_pair(edge.from->GetId(), edge.face->getId())] = edge;
+    }
+  }
+  return edges;
+}
 
-            FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                std::get<1>(dist.second));
-          }
-        }
-      }
+/**
+ * @brief Convert the last shortest path tree of graph to a boost::DistancesMap
+ */
+static void
+StoreDistances(const RoutingGraph& graph, uint32_t source, boost::DistancesMap& distances)
+{
+  distances.clear();
+  for (uint32_t v = 0; v < graph.GetNVertices(); v++) {
+    int32_t firstHop = graph.GetFirstHop(v);
+    if (v == source) {
+      distances[graph.GetRouter(v)] = boost::WeightZero;
+    }
+    else if (firstHop < 0) {
+      distances[graph.GetRouter(v)] = boost::WeightInf;
+    }
+    else {
+      distances[graph.GetRouter(v)] = std::make_tuple(graph.GetFace(firstHop), graph.GetDistance(v), 0.0);
     }
   }
 }
 
-void
-AddRoute(Ptr<Node> node, const Name& prefix, std::shared_ptr<nfd::Face> face, int32_t metric)
+/**
+ * @brief Get the distance of router in the tree rooted at source, false if it is unreachable
+ */
+static bool
+GetDistance(const boost::DistancesMap& distances, Ptr<GlobalRouter> source, Ptr<GlobalRouter> router,
+            uint32_t& distance)
 {
-  auto& fib = node->GetObject<L3Protocol>()->getForwarder()->getFib();
-  auto pEntry = fib.findExactMatch(prefix);
-  if (pEntry != nullptr) {
-    // NS_LOG_UNCOND(Names::FindName(node) << prefix << face->getId() << " " << pEntry->getNextHops().size());
-    BOOST_ASSERT(pEntry->getNextHops().size() == 1);
-    if (pEntry->hasNextHop(*face, 0)) {
-      // same route, pass
-      return;
+  if (router == source) {
+    distance = 0;
+    return true;
+  }
+  auto dist = distances.find(router);
+  if (dist == distances.end() || std::get<0>(dist->second) == nullptr) {
+    return false;
+  }
+  distance = std::get<1>(dist->second);
+  return true;
+}
+
+/**
+ * @brief Replace the routes of node towards the prefixes of origin if the next hop changed
+ * @return whether the routes were replaced
+ */
+static bool
+UpdateNextHop(Ptr<Node> node, Ptr<GlobalRouter> origin, std::shared_ptr<nfd::Face> oldFace,
+              const boost::DistancesMap::mapped_type& dist, FibUpdateTransaction& fibUpdates)
+{
+  const auto& newFace = std::get<0>(dist);
+  if (newFace == oldFace) {
+    return false;
+  }
+  for (const auto& prefix : origin->GetLocalPrefixes()) {
+    if (newFace != nullptr) {
+      NS_LOG_DEBUG(" prefix " << *prefix << " now reachable via face " << newFace->getId()
+                   << " with distance " << std::get<1>(dist));
+      AddRoute(node, *prefix, newFace, std::get<1>(dist), fibUpdates);
     }
     else {
-      fib.erase(*pEntry);
+      NS_LOG_DEBUG(" prefix " << *prefix << " is no longer reachable");
+      fibUpdates.RemoveRoute(node, *prefix, oldFace);
     }
   }
-  FibHelper::AddRoute(node, prefix, face, metric);
+  return true;
 }
 
 void
 GlobalRoutingHelper::CalculateRoutes(map<Ptr<Node>, boost::DistancesMap>* distancesMap)
 {
   BOOST_ASSERT(distancesMap);
-  /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
-   */
 
-  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
-  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
+  RoutingGraph graph;
+  m_routingEdges = SnapshotEdges(graph);
+  FibUpdateTransaction fibUpdates;
 
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  for (uint32_t source = 0; source < graph.GetNVertices(); source++) {
+    graph.ShortestPaths(source);
 
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
-      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
-      continue;
+    Ptr<Node> node = graph.GetNode(source);
+    StoreDistances(graph, source, (*distancesMap)[node]);
+
+    NS_LOG_DEBUG("Reachability from Node: " << node->GetId() << ", name: " << Names::FindName(node));
+    for (uint32_t v = 0; v < graph.GetNVertices(); v++) {
+      int32_t firstHop = graph.GetFirstHop(v);
+      if (firstHop < 0) {
+        continue; // the source itself, or unreachable
+      }
+      for (const auto& prefix : graph.GetRouter(v)->GetLocalPrefixes()) {
+        NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *graph.GetFace(firstHop)
+                     << ", ID: " << graph.GetFace(firstHop)->getId()
+                     << " with distance " << graph.GetDistance(v));
+
+        AddRoute(node, *prefix, graph.GetFace(firstHop), graph.GetDistance(v), fibUpdates);
+      }
     }
+  }
 
-    boost::DistancesMap distances;
+  fibUpdates.Commit();
+}
 
-    dijkstra_shortest_paths(graph, source,
-                            // predecessor_map (boost::ref(predecessors))
-                            // .
-                            distance_map(boost::ref(distances))
-                              .distance_inf(boost::WeightInf)
-                              .distance_zero(boost::WeightZero)
-                              .distance_compare(boost::WeightCompare())
-                              .distance_combine(boost::WeightCombine()));
+void
+GlobalRoutingHelper::UpdateRoutes(map<Ptr<Node>, boost::DistancesMap>* distancesMap)
+{
+  BOOST_ASSERT(distancesMap);
+  if (distancesMap->empty()) {
+    CalculateRoutes(distancesMap);
+    return;
+  }
 
-    (*distancesMap)[*node] = distances;
+  RoutingGraph graph;
+  RoutingEdges edges = SnapshotEdges(graph);
 
-    // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+  // edges that got longer can only lengthen shortest paths, edges that got shorter only shorten them
+  std::vector<RoutingEdge> longer;
+  std::vector<RoutingEdge> shorter;
+  for (const auto& old : m_routingEdges) {
+    auto edge = edges.find(old.first);
+    if (edge == edges.end() || edge->second.metric > old.second.metric) {
+      longer.push_back(old.second);
+    }
+  }
+  for (const auto& edge : edges) {
+    auto old = m_routingEdges.find(edge.first);
+    if (old == m_routingEdges.end() || edge.second.metric < old->second.metric) {
+      shorter.push_back(edge.second);
+    }
+  }
+  m_routingEdges.swap(edges);
 
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    std::shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
+  if (longer.empty() && shorter.empty()) {
+    NS_LOG_DEBUG("No edge changed, routes are up to date");
+    return;
+  }
+  NS_LOG_DEBUG(longer.size() << " edges got longer, " << shorter.size() << " edges got shorter");
+
+  FibUpdateTransaction fibUpdates;
+  size_t nRecomputed = 0;
+  size_t nRepaired = 0;
+  size_t nChanged = 0;
+  for (uint32_t sourceIdx = 0; sourceIdx < graph.GetNVertices(); sourceIdx++) {
+    Ptr<GlobalRouter> source = graph.GetRouter(sourceIdx);
+    Ptr<Node> node = graph.GetNode(sourceIdx);
+    boost::DistancesMap& distances = (*distancesMap)[node];
+
+    // a longer edge matters only if it is tight, i.e., it may lie on a shortest path of the tree
+    bool isAffected = distances.empty();
+    for (const auto& edge : longer) {
+      uint32_t from, to;
+      if (GetDistance(distances, source, edge.from, from) &&
+          GetDistance(distances, source, edge.to, to) && from + edge.metric == to) {
+        isAffected = true;
+        break;
+      }
+    }
 
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId() << ", name: " << Names::FindName(source->GetObject<Node>()));
-    for (const auto& dist : distances) {
-      if (dist.first == source)
-        continue;
-      else {
-        // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-        if (std::get<0>(dist.second) == 0) {
-          // cout << " is unreachable" << endl;
+    if (isAffected) {
+      graph.ShortestPaths(sourceIdx);
+      for (uint32_t v = 0; v < graph.GetNVertices(); v++) {
+        if (v == sourceIdx) {
+          continue;
         }
-        else {
-          for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-            NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *std::get<0>(dist.second) << ", ID: " << std::get<0>(dist.second)->getId()
-                         << " with distance " << std::get<1>(dist.second) << " with delay "
-                         << std::get<2>(dist.second));
+        int32_t firstHop = graph.GetFirstHop(v);
+        auto dist = firstHop < 0 ? boost::DistancesMap::mapped_type(boost::WeightInf) :
+                                   std::make_tuple(graph.GetFace(firstHop), graph.GetDistance(v), 0.0);
+        auto old = distances.find(graph.GetRouter(v));
+        auto oldFace = old != distances.end() ? std::get<0>(old->second) : nullptr;
+        nChanged += UpdateNextHop(node, graph.GetRouter(v), oldFace, dist, fibUpdates);
+      }
+      StoreDistances(graph, sourceIdx, distances);
+      nRecomputed++;
+      continue;
+    }
 
-            AddRoute(*node, *prefix, std::get<0>(dist.second), std::get<1>(dist.second));
-          }
+    // propagate shorter edges from their tails, relaxing only strict improvements
+    typedef std::pair<uint32_t, Ptr<GlobalRouter>> QueueEntry;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    for (const auto& edge : shorter) {
+      uint32_t from, to;
+      if (GetDistance(distances, source, edge.from, from) &&
+          (!GetDistance(distances, source, edge.to, to) || from + edge.metric < to)) {
+        queue.push(std::make_pair(from, edge.from));
+      }
+    }
+    if (queue.empty()) {
+      continue;
+    }
+
+    std::map<Ptr<GlobalRouter>, std::shared_ptr<nfd::Face>> oldFaces;
+    while (!queue.empty()) {
+      uint32_t from = queue.top().first;
+      Ptr<GlobalRouter> router = queue.top().second;
+      queue.pop();
+
+      uint32_t current;
+      if (!GetDistance(distances, source, router, current) || current < from) {
+        continue; // outdated entry
+      }
+      for (const auto& incidency : router->GetIncidencies()) {
+        const auto& face = std::get<1>(incidency);
+        Ptr<GlobalRouter> next = std::get<2>(incidency);
+        if (face == nullptr || next == source) {
+          continue;
+        }
+        uint32_t distance = from + static_cast<uint16_t>(face->getMetric());
+        uint32_t to;
+        if (GetDistance(distances, source, next, to) && to <= distance) {
+          continue;
         }
+        auto& dist = distances[next];
+        oldFaces.insert(std::make_pair(next, std::get<0>(dist)));
+        auto firstHop = router == source ? face : std::get<0>(distances[router]);
+        dist = std::make_tuple(firstHop, distance, 0.0);
+        queue.push(std::make_pair(distance, next));
       }
     }
+
+    for (const auto& old : oldFaces) {
+      nChanged += UpdateNextHop(node, old.first, old.second, distances[old.first], fibUpdates);
+    }
+    nRepaired++;
   }
+
+  fibUpdates.Commit();
+
+  NS_LOG_INFO("Updated routes: " << nRecomputed << " trees recomputed, " << nRepaired
+              << " trees repaired, " << nChanged << " next hops changed");
 }
 
 void
@@ -387,6 +519,7 @@ GlobalRoutingHelper::UpdatePrefixes(map<Ptr<Node>, boost::DistancesMap>* distanc
 
   boost::NdnGlobalRouterGraph graph;
   // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
+  FibUpdateTransaction fibUpdates;
 
   // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
   // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
@@ -421,119 +554,47 @@ GlobalRoutingHelper::UpdatePrefixes(map<Ptr<Node>, boost::DistancesMap>* distanc
                          << " with distance " << std::get<1>(dist.second) << " with delay "
                          << std::get<2>(dist.second));
 
-            AddRoute(*node, *prefix, std::get<0>(dist.second), std::get<1>(dist.second));
+            AddRoute(*node, *prefix, std::get<0>(dist.second), std::get<1>(dist.second), fibUpdates);
           }
         }
       }
     }
   }
+
+  fibUpdates.Commit();
 }
 
 void
 GlobalRoutingHelper::CalculateAllPossibleRoutes()
 {
-  /**
-   * Implementation of route calculation is heavily based on Boost Graph Library
-   * See http://www.boost.org/doc/libs/1_49_0/libs/graph/doc/table_of_contents.html for more details
-   */
-
-  BOOST_CONCEPT_ASSERT((boost::VertexListGraphConcept<boost::NdnGlobalRouterGraph>));
-  BOOST_CONCEPT_ASSERT((boost::IncidenceGraphConcept<boost::NdnGlobalRouterGraph>));
-
-  boost::NdnGlobalRouterGraph graph;
-  // typedef graph_traits < NdnGlobalRouterGraph >::vertex_descriptor vertex_descriptor;
-
-  // For now we doing Dijkstra for every node.  Can be replaced with Bellman-Ford or Floyd-Warshall.
-  // Other algorithms should be faster, but they need additional EdgeListGraph concept provided by
-  // the graph, which
-  // is not obviously how implement in an efficient manner
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<GlobalRouter> source = (*node)->GetObject<GlobalRouter>();
-    if (source == 0) {
-      NS_LOG_DEBUG("Node " << (*node)->GetId() << " does not export GlobalRouter interface");
-      continue;
-    }
-
-    Ptr<L3Protocol> L3protocol = (*node)->GetObject<L3Protocol>();
-    std::shared_ptr<nfd::Forwarder> forwarder = L3protocol->getForwarder();
-
-    NS_LOG_DEBUG("Reachability from Node: " << source->GetObject<Node>()->GetId() << " ("
-                                            << Names::FindName(source->GetObject<Node>()) << ")");
-
-    Ptr<L3Protocol> l3 = source->GetObject<L3Protocol>();
-    NS_ASSERT(l3 != 0);
-
-    // remember interface statuses
-    std::list<nfd::FaceId> faceIds;
-    std::unordered_map<nfd::FaceId, uint16_t> originalMetrics;
-    for (auto& nfdFace : l3->getForwarder()->getFaceTable()) {
-      faceIds.push_back(nfdFace.getId());
-      originalMetrics[nfdFace.getId()] = nfdFace.getMetric();
-      nfdFace.setMetric(std::numeric_limits<uint16_t>::max() - 1);
-      // value std::numeric_limits<uint16_t>::max () MUST NOT be used (reserved)
-    }
-
-    for (auto& faceId : faceIds) {
-      auto* face = l3->getForwarder()->getFaceTable().get(faceId);
-      NS_ASSERT(face != nullptr);
-      auto transport = dynamic_cast<UserLinkTransport*>(face->getTransport());
-      if (transport == nullptr) {
-        NS_LOG_DEBUG("Skipping non ndnSIM-specific transport face");
-        continue;
-      }
-
-      // enabling only faceId
-      face->setMetric(originalMetrics[faceId]);
+  RoutingGraph graph;
+  FibUpdateTransaction fibUpdates;
 
-      boost::DistancesMap distances;
+  for (uint32_t source = 0; source < graph.GetNVertices(); source++) {
+    Ptr<Node> node = graph.GetNode(source);
+    NS_LOG_DEBUG("Reachability from Node: " << node->GetId() << " (" << Names::FindName(node) << ")");
 
+    // enabling only one face of the source at a time
+    for (uint32_t e = graph.EdgesBegin(source); e < graph.EdgesEnd(source); e++) {
       NS_LOG_DEBUG("-----------");
 
-      dijkstra_shortest_paths(graph, source,
-                              // predecessor_map (boost::ref(predecessors))
-                              // .
-                              distance_map(boost::ref(distances))
-                                .distance_inf(boost::WeightInf)
-                                .distance_zero(boost::WeightZero)
-                                .distance_compare(boost::WeightCompare())
-                                .distance_combine(boost::WeightCombine()));
+      graph.ShortestPaths(source, e);
 
-      // NS_LOG_DEBUG (predecessors.size () << ", " << distances.size ());
+      for (uint32_t v = 0; v < graph.GetNVertices(); v++) {
+        if (graph.GetFirstHop(v) < 0) {
+          continue; // the source itself, or unreachable
+        }
+        for (const auto& prefix : graph.GetRouter(v)->GetLocalPrefixes()) {
+          NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face " << *graph.GetFace(e)
+                       << " with distance " << graph.GetDistance(v));
 
-      for (const auto& dist : distances) {
-        if (dist.first == source)
-          continue;
-        else {
-          // cout << "  Node " << dist.first->GetObject<Node> ()->GetId ();
-          if (std::get<0>(dist.second) == 0) {
-            // cout << " is unreachable" << endl;
-          }
-          else {
-            for (const auto& prefix : dist.first->GetLocalPrefixes()) {
-              NS_LOG_DEBUG(" prefix " << *prefix << " reachable via face "
-                           << *std::get<0>(dist.second)
-                           << " with distance " << std::get<1>(dist.second)
-                           << " with delay " << std::get<2>(dist.second));
-
-              if (std::get<0>(dist.second)->getMetric() == std::numeric_limits<uint16_t>::max() - 1)
-                continue;
-
-              FibHelper::AddRoute(*node, *prefix, std::get<0>(dist.second),
-                                  std::get<1>(dist.second));
-            }
-          }
+          fibUpdates.AddRoute(node, *prefix, graph.GetFace(e), graph.GetDistance(v));
         }
       }
-
-      // disabling the face again
-      face->setMetric(std::numeric_limits<uint16_t>::max() - 1);
-    }
-
-    // recover original interface statuses
-    for (auto& i : originalMetrics) {
-      l3->getForwarder()->getFaceTable().get(i.first)->setMetric(i.second);
     }
   }
+
+  fibUpdates.Commit();
 }
 
 } // namespace sat
@@ -49,6 +49,8 @@ namespace sat {
 
 using std::map;
 
+class RoutingGraph;
+
 /**
  * @ingroup ndn-helpers
  * @brief Helper for GlobalRouter interface (SIN)
@@ -119,10 +121,25 @@ public:
 
   /**
    * @brief Calculate for every node shortest path trees and install routes to all prefix origins
+   *
+   * The trees are cached in distancesMap, and the helper remembers the face metrics they were
+   * computed with, so that UpdateRoutes can later repair them.
    */
-  static void
+  void
   CalculateRoutes(map<Ptr<Node>, boost::DistancesMap>* distancesMap);
 
+  /**
+   * @brief Repair the shortest path trees cached by CalculateRoutes after face metrics or
+   *        incidencies changed, and update the affected routes
+   *
+   * A tree is recomputed only if it may use an edge that got longer or disappeared; edges that got
+   * shorter or appeared are propagated from their tail only.  Trees not affected by any change are
+   * left alone, and FIB entries are replaced only for origins whose next hop changed.
+   * Calculates the routes if distancesMap is empty.
+   */
+  void
+  UpdateRoutes(map<Ptr<Node>, boost::DistancesMap>* distancesMap);
+
   static void
   UpdatePrefixes(map<Ptr<Node>, boost::DistancesMap>* distancesMap);
 
@@ -140,6 +157,24 @@ public:
 private:
   void
   Install(Ptr<Channel> channel);
+
+  /**
+   * @brief An edge of the routing graph, as seen by the last route computation
+   */
+  struct RoutingEdge {
+    Ptr<GlobalRouter> from;
+    Ptr<GlobalRouter> to;
+    std::shared_ptr<nfd::Face> face;
+    uint16_t metric;
+  };
+
+  // keyed by (GlobalRouter ID, face ID)
+  typedef std::map<std::pair<uint32_t, nfd::FaceId>, RoutingEdge> RoutingEdges;
+
+  static RoutingEdges
+  SnapshotEdges(const RoutingGraph& graph);
+
+  RoutingEdges m_routingEdges; // edges the trees cached by CalculateRoutes/UpdateRoutes were computed with
 };
 
 } // namespace sat
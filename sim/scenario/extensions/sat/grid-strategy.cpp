@@ -0,0 +1,234 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "grid-strategy.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/algorithm.hpp"
+#include "ns3/ndnSIM/NFD/core/logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+namespace nfd {
+namespace fw {
+
+NFD_REGISTER_STRATEGY(GridStrategy);
+
+NFD_LOG_INIT(GridStrategy);
+
+const time::milliseconds GridStrategy::RETX_SUPPRESSION_INITIAL(10);
+const time::milliseconds GridStrategy::RETX_SUPPRESSION_MAX(250);
+
+/** \return shortest signed distance from 0 to \p delta on a ring of \p size positions
+ */
+static int
+wrapDelta(int delta, int size)
+{
+  delta = ((delta % size) + size) % size;
+  return delta > size / 2 ? delta - size : delta;
+}
+
+GridStrategy::GridStrategy(Forwarder& forwarder, const Name& name)
+  : Strategy(forwarder)
+  , m_hasLocation(false)
+  , m_location{0, 0}
+  , m_gridSize{0, 0}
+  , m_retxSuppression(RETX_SUPPRESSION_INITIAL,
+                      RetxSuppressionExponential::DEFAULT_MULTIPLIER,
+                      RETX_SUPPRESSION_MAX)
+{
+  ParsedInstanceName parsed = parseInstanceName(name);
+  if (!parsed.parameters.empty()) {
+    BOOST_THROW_EXCEPTION(std::invalid_argument("GridStrategy does not accept parameters"));
+  }
+  if (parsed.version && *parsed.version != getStrategyName()[-1].toVersion()) {
+    BOOST_THROW_EXCEPTION(std::invalid_argument(
+      "GridStrategy does not support version " + to_string(*parsed.version)));
+  }
+  this->setInstanceName(makeInstanceName(name, getStrategyName()));
+  m_neighbors.fill(face::INVALID_FACEID);
+}
+
+const Name&
+GridStrategy::getStrategyName()
+{
+  static Name strategyName("/localhost/nfd/strategy/orbit-grid/%FD%01");
+  return strategyName;
+}
+
+bool
+GridStrategy::parseSatName(const std::string& name, GridCoord& coord)
+{
+  int consumed = 0;
+  if (std::sscanf(name.c_str(), "sat-%d-%d%n", &coord.orbit, &coord.sat, &consumed) != 2 ||
+      static_cast<size_t>(consumed) != name.size()) {
+    return false;
+  }
+  return coord.orbit >= 0 && coord.sat >= 0;
+}
+
+void
+GridStrategy::setLocation(const GridCoord& location, const GridCoord& gridSize)
+{
+  BOOST_ASSERT(gridSize.orbit > 0 && gridSize.sat > 0);
+  m_location = location;
+  m_gridSize = gridSize;
+  m_hasLocation = true;
+}
+
+void
+GridStrategy::setNeighbor(Direction direction, FaceId faceId)
+{
+  BOOST_ASSERT(direction < N_DIRECTIONS);
+  m_neighbors[direction] = faceId;
+}
+
+void
+GridStrategy::setDestination(const Name& prefix, const Name& satRegion)
+{
+  if (satRegion.empty()) {
+    m_destinations.erase(prefix);
+  }
+  else {
+    m_destinations[prefix] = satRegion;
+  }
+}
+
+void
+GridStrategy::afterReceiveInterest(const Face& inFace, const Interest& interest,
+                                   const shared_ptr<pit::Entry>& pitEntry)
+{
+  if (m_retxSuppression.decidePerPitEntry(*pitEntry) == RetxSuppressionResult::SUPPRESS) {
+    NFD_LOG_DEBUG(interest << " from=" << inFace.getId() << " suppressed");
+    return;
+  }
+
+  const DelegationList& hint = interest.getForwardingHint();
+  if (hint.empty()) {
+    // station: put the satellite of the producer in the forwarding hint
+    const Name* satRegion = nullptr;
+    size_t matchSize = 0;
+    for (const auto& destination : m_destinations) {
+      if (destination.first.isPrefixOf(interest.getName()) &&
+          (satRegion == nullptr || destination.first.size() >= matchSize)) {
+        satRegion = &destination.second;
+        matchSize = destination.first.size();
+      }
+    }
+    if (satRegion != nullptr) {
+      Interest newInterest(interest);
+      DelegationList del;
+      del.insert(1, *satRegion);
+      newInterest.setForwardingHint(del);
+      NFD_LOG_DEBUG(interest << " from=" << inFace.getId() << " with hint=" << *satRegion);
+      this->forwardToFib(inFace, newInterest, pitEntry);
+      return;
+    }
+
+    // destination satellite, hint stripped by the forwarder, or no destination known
+    this->forwardToFib(inFace, interest, pitEntry);
+    return;
+  }
+
+  Face* outFace = this->findGridNextHop(inFace, hint);
+  if (outFace == nullptr) {
+    this->forwardToFib(inFace, interest, pitEntry);
+    return;
+  }
+
+  NFD_LOG_DEBUG(interest << " from=" << inFace.getId() << " grid-to=" << outFace->getId());
+  this->sendInterest(pitEntry, *outFace, interest);
+}
+
+Face*
+GridStrategy::findGridNextHop(const Face& inFace, const DelegationList& hint) const
+{
+  if (!m_hasLocation) {
+    return nullptr;
+  }
+
+  GridCoord destination;
+  bool isFound = false;
+  for (const Delegation& del : hint) {
+    if (!del.name.empty() && parseSatName(del.name[-1].toUri(), destination)) {
+      isFound = true;
+      break;
+    }
+  }
+  if (!isFound) {
+    return nullptr;
+  }
+
+  int dOrbit = wrapDelta(destination.orbit - m_location.orbit, m_gridSize.orbit);
+  int dSat = wrapDelta(destination.sat - m_location.sat, m_gridSize.sat);
+  if (dOrbit == 0 && dSat == 0) {
+    // region of this satellite is not set, leave the Interest to the FIB
+    return nullptr;
+  }
+
+  // move along the dimension with more hops left first, then the other one; directions away from
+  // the destination come last, they are only taken where ISLs are missing from the grid
+  Direction orbitDir = dOrbit > 0 ? ORBIT_NEXT : ORBIT_PREV;
+  Direction satDir = dSat > 0 ? SAT_NEXT : SAT_PREV;
+  std::array<Direction, N_DIRECTIONS> order;
+  size_t nOrdered = 0;
+  auto addDirection = [&] (Direction direction) {
+    if (std::find(order.begin(), order.begin() + nOrdered, direction) == order.begin() + nOrdered) {
+      order[nOrdered++] = direction;
+    }
+  };
+  if (std::abs(dOrbit) >= std::abs(dSat)) {
+    addDirection(orbitDir);
+    if (dSat != 0) {
+      addDirection(satDir);
+    }
+  }
+  else {
+    addDirection(satDir);
+    if (dOrbit != 0) {
+      addDirection(orbitDir);
+    }
+  }
+  for (int direction = 0; direction < N_DIRECTIONS; ++direction) {
+    addDirection(static_cast<Direction>(direction));
+  }
+
+  for (Direction direction : order) {
+    Face* face = this->getFace(m_neighbors[direction]);
+    if (face != nullptr && face->getId() != inFace.getId()) {
+      return face;
+    }
+  }
+  return nullptr;
+}
+
+void
+GridStrategy::forwardToFib(const Face& inFace, const Interest& interest,
+                           const shared_ptr<pit::Entry>& pitEntry)
+{
+  // nexthops are ordered by cost, use the first eligible one as best-route does
+  const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+  for (const auto& nexthop : fibEntry.getNextHops()) {
+    Face& outFace = nexthop.getFace();
+    if ((outFace.getId() == inFace.getId() && outFace.getLinkType() != ndn::nfd::LINK_TYPE_AD_HOC) ||
+        wouldViolateScope(inFace, interest, outFace)) {
+      continue;
+    }
+    NFD_LOG_DEBUG(interest << " from=" << inFace.getId() << " fib-to=" << outFace.getId());
+    this->sendInterest(pitEntry, outFace, interest);
+    return;
+  }
+
+  NFD_LOG_DEBUG(interest << " from=" << inFace.getId() << " noNextHop");
+  lp::NackHeader nackHeader;
+  nackHeader.setReason(lp::NackReason::NO_ROUTE);
+  this->sendNack(pitEntry, inFace, nackHeader);
+  this->rejectPendingInterest(pitEntry);
+}
+
+} // namespace fw
+} // namespace nfd
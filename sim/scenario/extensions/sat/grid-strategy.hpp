@@ -0,0 +1,111 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef NFD_DAEMON_FW_GRID_STRATEGY_HPP
+#define NFD_DAEMON_FW_GRID_STRATEGY_HPP
+
+#include "ns3/ndnSIM/NFD/daemon/fw/strategy.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/retx-suppression-exponential.hpp"
+
+#include <array>
+
+namespace nfd {
+namespace fw {
+
+/** \brief position of a satellite in the +Grid of ISLs, as named by getSatId in Leo.py
+ */
+struct GridCoord
+{
+  int orbit;
+  int sat;
+};
+
+/** \brief A forwarding strategy that steers Interests over the +Grid of ISLs towards a satellite
+ *
+ *  The destination satellite is carried in the forwarding hint, as /nodes/sats/sat-<orbit>-<sat>.
+ *  A satellite forwards the Interest to the ISL neighbor that is closer to the destination, using
+ *  only its own position and neighbors, set once at install time, so routes of the constellation
+ *  need not be pushed into FIBs as the user links change. The forwarding hint is stripped on the
+ *  destination satellite, whose network region is its satellite name, then the FIB route of the
+ *  attached station is used.
+ *
+ *  A station adds the forwarding hint to Interests under the prefixes given by setDestination.
+ *  Interests without forwarding hint, or that cannot make progress on the grid, follow the
+ *  lowest-cost FIB nexthop.
+ */
+class GridStrategy : public Strategy
+{
+public:
+  enum Direction {
+    ORBIT_NEXT,
+    ORBIT_PREV,
+    SAT_NEXT,
+    SAT_PREV,
+    N_DIRECTIONS
+  };
+
+  explicit
+  GridStrategy(Forwarder& forwarder, const Name& name = getStrategyName());
+
+  static const Name&
+  getStrategyName();
+
+  /** \brief parses a satellite name sat-<orbit>-<sat>
+   *  \return false if \p name is not a satellite name
+   */
+  static bool
+  parseSatName(const std::string& name, GridCoord& coord);
+
+  /** \brief sets the position of this satellite, and the size of the grid
+   */
+  void
+  setLocation(const GridCoord& location, const GridCoord& gridSize);
+
+  /** \brief sets the face of the ISL towards \p direction
+   */
+  void
+  setNeighbor(Direction direction, FaceId faceId);
+
+  /** \brief sets the satellite region to put in the forwarding hint of Interests under \p prefix
+   *
+   *  An empty \p satRegion removes the destination.
+   */
+  void
+  setDestination(const Name& prefix, const Name& satRegion);
+
+  void
+  afterReceiveInterest(const Face& inFace, const Interest& interest,
+                       const shared_ptr<pit::Entry>& pitEntry) override;
+
+private:
+  /** \return the face of the ISL towards the destination satellite in \p hint,
+   *          or nullptr if the destination is unknown or unreachable from here
+   */
+  Face*
+  findGridNextHop(const Face& inFace, const DelegationList& hint) const;
+
+  void
+  forwardToFib(const Face& inFace, const Interest& interest,
+               const shared_ptr<pit::Entry>& pitEntry);
+
+private:
+  bool m_hasLocation;
+  GridCoord m_location;
+  GridCoord m_gridSize;
+  std::array<FaceId, N_DIRECTIONS> m_neighbors;
+  std::map<Name, Name> m_destinations; // prefix => satellite region
+  RetxSuppressionExponential m_retxSuppression;
+
+PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  static const time::milliseconds RETX_SUPPRESSION_INITIAL;
+  static const time::milliseconds RETX_SUPPRESSION_MAX;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_GRID_STRATEGY_HPP
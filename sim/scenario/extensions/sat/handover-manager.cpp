@@ -17,7 +17,13 @@
 #include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
 
 #include "ns3/channel.h"
+#include "ns3/data-rate.h"
+#include "ns3/pointer.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <string>
 
 NS_LOG_COMPONENT_DEFINE("ndn.sat.HandoverManager");
@@ -30,13 +36,32 @@ NS_OBJECT_ENSURE_REGISTERED(HandoverManager);
 
 uint64_t HandoverManager::m_hopLimit = 2;
 
+LinkId
+HandoverManager::AllocateLinkId()
+{
+  static LinkId lastId = INVALID_LINK_ID;
+  return ++lastId;
+}
+
 TypeId
 HandoverManager::GetTypeId()
 {
   static TypeId tid = TypeId("ns3::ndn::sat::HandoverManager").SetGroupName("Sat").SetParent<Object>().AddConstructor<HandoverManager>()
                       .AddTraceSource("ForwardPayloads", "ForwardPayloads",
                                       MakeTraceSourceAccessor(&HandoverManager::m_forwardPayload),
-                                      "ns3::ndn::sat::HandoverManager::PayloadTraceCallback");
+                                      "ns3::ndn::sat::HandoverManager::PayloadTraceCallback")
+                      .AddAttribute("MaxBufferBytes", "Maximum size of the packets buffered for a tunnel, oldest packets are dropped first",
+                                    UintegerValue(1 << 20), MakeUintegerAccessor(&HandoverManager::m_maxBufferBytes),
+                                    MakeUintegerChecker<uint64_t>())
+                      .AddAttribute("MaxBufferAge", "Buffered packets are dropped after this time, e.g., when they can no longer satisfy Interests",
+                                    TimeValue(Seconds(2)), MakeTimeAccessor(&HandoverManager::m_maxBufferAge),
+                                    MakeTimeChecker())
+                      .AddAttribute("FlushQueueBytes", "Buffered packets are flushed only while the outgoing device queue holds fewer bytes than this",
+                                    UintegerValue(64 * 1024), MakeUintegerAccessor(&HandoverManager::m_flushQueueBytes),
+                                    MakeUintegerChecker<uint64_t>())
+                      .AddAttribute("UserLinkLinger", "Faces of a broken user link are closed and their devices reused after this time, tunnelled packets are delivered to them until then",
+                                    TimeValue(Seconds(10)), MakeTimeAccessor(&HandoverManager::m_userLinkLinger),
+                                    MakeTimeChecker());
   return tid;
 }
 
@@ -47,6 +72,11 @@ HandoverManager::HandoverManager()
   , m_outAcks(0)
   , m_inPayloads(0)
   , m_outPayloads(0)
+  , m_overflowDrops(0)
+  , m_expiryDrops(0)
+  , m_bufferedBytes(0)
+  , m_peakBufferedBytes(0)
+  , m_flushes(0)
 {
 }
 
@@ -66,37 +96,168 @@ HandoverManager::GetL3Protocol() const
 }
 
 void
-HandoverManager::TunnelPacket(const ::nfd::face::Transport::Packet& packet, string tunnelId)
+HandoverManager::TunnelPacket(const ::nfd::face::Transport::Packet& packet, LinkId tunnelId)
 {
   NS_LOG_DEBUG("Tunnel packet via tunnel " << tunnelId);
+
+  auto entry = m_tib.Find(tunnelId);
+  if (entry == nullptr) {
+    NS_LOG_DEBUG("Tunnel not yet established for " << tunnelId);
+    // queue for later transmission
+    BufferPacket(packet, tunnelId);
+  }
+  else if (m_dt.Contains(tunnelId)) {
+    // keep the order behind packets still being flushed
+    BufferPacket(packet, tunnelId);
+    StartFlush(tunnelId);
+  }
+  else {
+    auto nexthop = entry->first;
+    if (nexthop == nullptr) {
+      nexthop = entry->second;
+    }
+    SendPayload(packet, tunnelId, nexthop);
+  }
+}
+
+void
+HandoverManager::SendPayload(const ::nfd::face::Transport::Packet& packet, LinkId tunnelId, Ptr<NetDevice> nexthop)
+{
+  NS_LOG_DEBUG("Tunnelling packet through " << nexthop->GetAddress());
   core::LinkPayload payloadPacket(tunnelId, packet.packet);
   // create transport packet based on the LinkPayload packet
   ::nfd::face::Transport::Packet newPacket(Block(payloadPacket.wireEncode()));
-
   // convert NFD packet to NS3 packet
-  BlockHeader header(newPacket); // header is defined to classify NDN-borne packets
+  Ptr<Packet> ns3Packet = BlockHeader::CreatePacket(newPacket.packet, nexthop);
+  nexthop->Send(ns3Packet, nexthop->GetBroadcast(), L3Protocol::ETHERNET_FRAME_TYPE);
+}
 
-  Ptr<Packet> ns3Packet = Create<Packet>();
-  ns3Packet->AddHeader(header);
+void
+HandoverManager::BufferPacket(const ::nfd::face::Transport::Packet& packet, LinkId tunnelId)
+{
+  if (!m_dt.Contains(tunnelId)) {
+    NS_LOG_DEBUG("Buffer data for " << tunnelId);
+  }
+  auto& buffer = m_dt[tunnelId];
+  buffer.packets.push_back(TunnelBuffer::Entry{packet, Simulator::Now()});
+  buffer.nBytes += packet.packet.size();
+  m_bufferedBytes += packet.packet.size();
+  m_peakBufferedBytes = std::max(m_peakBufferedBytes, m_bufferedBytes);
 
-  // send the NS3 packet
-  if (m_tib.find(tunnelId) == m_tib.end()) {
-    NS_LOG_DEBUG("Tunnel not yet established for " << tunnelId);
-    // queue for later transmission
-    if (m_dt.find(tunnelId) == m_dt.end()) {
-      NS_LOG_DEBUG("Buffer data for " << tunnelId);
-      m_dt[tunnelId] = vector<::nfd::face::Transport::Packet>();
-    }
-    m_dt[tunnelId].push_back(packet);
+  while (buffer.nBytes > m_maxBufferBytes) {
+    NS_LOG_DEBUG("Buffer of " << tunnelId << " is full, drop the oldest packet");
+    PopPacket(buffer);
+    m_overflowDrops++;
   }
-  else {
-    auto nexthop = m_tib[tunnelId].first;
-    if (nexthop == nullptr) {
-      nexthop = m_tib[tunnelId].second;
+
+  if (!buffer.expiryEvent.IsRunning() && !buffer.packets.empty()) {
+    buffer.expiryEvent = Simulator::Schedule(buffer.packets.front().arrival + m_maxBufferAge - Simulator::Now(),
+                                             &HandoverManager::ExpireBuffer, this, tunnelId);
+  }
+}
+
+void
+HandoverManager::PopPacket(TunnelBuffer& buffer)
+{
+  auto size = buffer.packets.front().packet.packet.size();
+  buffer.nBytes -= size;
+  m_bufferedBytes -= size;
+  buffer.packets.pop_front();
+}
+
+void
+HandoverManager::ExpireBuffer(LinkId tunnelId)
+{
+  auto buffer = m_dt.Find(tunnelId);
+  if (buffer == nullptr) {
+    return;
+  }
+
+  Time now = Simulator::Now();
+  while (!buffer->packets.empty() && buffer->packets.front().arrival + m_maxBufferAge <= now) {
+    NS_LOG_DEBUG("Drop expired packet buffered for " << tunnelId);
+    PopPacket(*buffer);
+    m_expiryDrops++;
+  }
+
+  if (!buffer->packets.empty()) {
+    buffer->expiryEvent = Simulator::Schedule(buffer->packets.front().arrival + m_maxBufferAge - now,
+                                              &HandoverManager::ExpireBuffer, this, tunnelId);
+  }
+  else if (!buffer->flushEvent.IsRunning()) {
+    m_dt.Erase(tunnelId);
+  }
+}
+
+void
+HandoverManager::StartFlush(LinkId tunnelId)
+{
+  auto buffer = m_dt.Find(tunnelId);
+  if (buffer == nullptr || buffer->flushEvent.IsRunning()) {
+    return;
+  }
+  NS_LOG_DEBUG("Send out buffered data for " << tunnelId);
+  buffer->flushStart = Simulator::Now();
+  m_flushes++;
+  FlushBuffer(tunnelId);
+}
+
+static uint64_t
+GetQueuedBytes(Ptr<NetDevice> device)
+{
+  PointerValue txQueueAttribute;
+  if (device->GetAttributeFailSafe("TxQueue", txQueueAttribute)) {
+    return txQueueAttribute.Get<QueueBase>()->GetNBytes();
+  }
+  return 0;
+}
+
+void
+HandoverManager::FlushBuffer(LinkId tunnelId)
+{
+  auto buffer = m_dt.Find(tunnelId);
+  auto entry = m_tib.Find(tunnelId);
+  if (buffer == nullptr || entry == nullptr) {
+    return;
+  }
+  auto nexthop = entry->first;
+  if (nexthop == nullptr) {
+    nexthop = entry->second;
+  }
+
+  Time now = Simulator::Now();
+  while (!buffer->packets.empty()) {
+    if (buffer->packets.front().arrival + m_maxBufferAge <= now) {
+      PopPacket(*buffer);
+      m_expiryDrops++;
+      continue;
     }
-    NS_LOG_DEBUG("Tunnelling packet through " << nexthop->GetAddress());
-    nexthop->Send(ns3Packet, nexthop->GetBroadcast(), L3Protocol::ETHERNET_FRAME_TYPE);
+
+    auto size = buffer->packets.front().packet.packet.size();
+    auto queued = GetQueuedBytes(nexthop);
+    if (queued > 0 && queued + size > m_flushQueueBytes) {
+      // wait until the device has transmitted enough of its queue
+      Time wait = MilliSeconds(1);
+      DataRateValue dataRate;
+      if (nexthop->GetAttributeFailSafe("DataRate", dataRate)) {
+        wait = dataRate.Get().CalculateBytesTxTime(queued + size - m_flushQueueBytes);
+      }
+      NS_LOG_DEBUG("Device queue of " << nexthop->GetAddress() << " holds " << queued << " bytes, resume flush in " << wait);
+      buffer->flushEvent = Simulator::Schedule(wait, &HandoverManager::FlushBuffer, this, tunnelId);
+      return;
+    }
+
+    auto packet = std::move(buffer->packets.front().packet);
+    PopPacket(*buffer);
+    SendPayload(packet, tunnelId, nexthop);
   }
+
+  Time latency = now - buffer->flushStart;
+  m_maxFlushLatency = std::max(m_maxFlushLatency, latency);
+  m_totalFlushLatency += latency;
+  NS_LOG_DEBUG("Flushed buffer of " << tunnelId << " in " << latency);
+  buffer->expiryEvent.Cancel();
+  m_dt.Erase(tunnelId);
 }
 
 void
@@ -109,26 +270,29 @@ HandoverManager::ProcessPacket(const ::nfd::face::Transport::Packet& packet, Ptr
     {
       m_inPayloads++;
       NS_LOG_DEBUG("Processing LinkPayload");
-      auto id = ::ndn::encoding::readString(wire.get(tlv::TunnelId));
-      auto entry = m_tib.find(id);
-      if (entry != m_tib.end()) {
+      LinkId id = ::ndn::encoding::readNonNegativeInteger(wire.get(tlv::TunnelId));
+      auto entry = m_tib.Find(id);
+      if (entry != nullptr) {
         // proceed if a match is found in TIB, else discard
-        auto end0 = std::pair<Ptr<NetDevice>, Ptr<NetDevice>>(nullptr, lasthop);
-        auto end1 = std::pair<Ptr<NetDevice>, Ptr<NetDevice>>(lasthop, nullptr);
-        if (entry->second == end0 || entry->second == end1) {
+        if ((entry->first == nullptr && entry->second == lasthop) ||
+            (entry->first == lasthop && entry->second == nullptr)) {
           // end of tunnel, hand up payload
           NS_LOG_DEBUG("End of tunnel for " << id << ", handing up payload to NDN");
-          auto faceId = m_faceIdTable[id];
-          ((UserLinkTransport*)(m_ndn->getFaceById(faceId)->getTransport()))
+          auto faceId = m_faceIdTable.Find(id);
+          if (faceId == nullptr) {
+            NS_LOG_DEBUG("Face of " << id << " already retired, discard payload");
+            break;
+          }
+          ((UserLinkTransport*)(m_ndn->getFaceById(*faceId)->getTransport()))
             ->inject(::nfd::face::Transport::Packet(Block(wire.get(tlv::Payload).blockFromValue())));
         }
         else {
           // traverse tunnel
           m_outPayloads++;
           NS_LOG_DEBUG("Traverse channel " << id);
-          auto nexthop = m_tib[id].first;
+          auto nexthop = entry->first;
           if (nexthop == lasthop) {
-            nexthop = m_tib[id].second;
+            nexthop = entry->second;
           }
           ((UserLinkTransport*)(m_ndn->getFaceByNetDevice(nexthop)->getTransport()))
             ->emit(::nfd::face::Transport::Packet(packet));
@@ -146,21 +310,14 @@ HandoverManager::ProcessPacket(const ::nfd::face::Transport::Packet& packet, Ptr
     {
       m_inReqs++;
       NS_LOG_DEBUG("Processing TunnelReq");
-      auto id = ::ndn::encoding::readString(wire.get(tlv::LinkId));
-      auto it = std::find(m_idList.begin(), m_idList.end(), id);
-      if (it != m_idList.end()) {
+      LinkId id = ::ndn::encoding::readNonNegativeInteger(wire.get(tlv::LinkId));
+      if (m_idList.Contains(id)) {
         // this is the target ground terminal, send ack
         NS_LOG_DEBUG("found sat, send ack for " << id);
-        m_tib[id] = std::pair<Ptr<NetDevice>, Ptr<NetDevice>>(nullptr, lasthop); // incoming link of req points to the ground terminal
+        m_tib.Insert(id, std::pair<Ptr<NetDevice>, Ptr<NetDevice>>(nullptr, lasthop)); // incoming link of req points to the ground terminal
         // send buffered data
-        if (m_dt.find(id) != m_dt.end()) {
-          NS_LOG_DEBUG("Send out buffered data for " << id);
-          for (auto& packet : m_dt[id]) {
-            TunnelPacket(packet, id);
-          }
-          m_dt.erase(id);
-        }
-        m_idList.erase(it);
+        StartFlush(id);
+        m_idList.Erase(id);
         core::TunnelAck ack(id);
         ::nfd::face::Transport::Packet ackPacket(Block(ack.wireEncode()));
         ((UserLinkTransport*)(m_ndn->getFaceByNetDevice(lasthop)->getTransport()))
@@ -168,12 +325,12 @@ HandoverManager::ProcessPacket(const ::nfd::face::Transport::Packet& packet, Ptr
         m_outAcks++;
       }
       else {
-        if (m_prt.find(id) != m_prt.end()) {
+        if (m_prt.Contains(id)) {
           NS_LOG_DEBUG("loop detected, discard tReq for " << id);
         }
         else {
           NS_LOG_DEBUG("update prt and broadcast for " << id);
-          m_prt[id] = lasthop;
+          m_prt.Insert(id, lasthop);
           BroadcastReq(id, ::ndn::encoding::readNonNegativeInteger(wire.get(tlv::HopLimit)), lasthop);
         }
       }
@@ -183,12 +340,13 @@ HandoverManager::ProcessPacket(const ::nfd::face::Transport::Packet& packet, Ptr
     {
       m_inAcks++;
       NS_LOG_DEBUG("Processing TunnelAck");
-      auto id = ::ndn::encoding::readString(wire.get(tlv::LinkId));
-      if (m_prt.find(id) == m_prt.end()) {
+      LinkId id = ::ndn::encoding::readNonNegativeInteger(wire.get(tlv::LinkId));
+      auto prtEntry = m_prt.Find(id);
+      if (prtEntry == nullptr) {
         NS_LOG_DEBUG("Unsolicited or redundant Ack, discard");
         break;
       }
-      auto rLasthop = m_prt[id]; // recorded incoming link of corresponding req
+      auto rLasthop = *prtEntry; // recorded incoming link of corresponding req
       if (rLasthop != nullptr) {
         // not destination, further forward
         NS_LOG_DEBUG("Forward according to PRT for " << id);
@@ -197,9 +355,13 @@ HandoverManager::ProcessPacket(const ::nfd::face::Transport::Packet& packet, Ptr
         m_outAcks++;
       }
       NS_LOG_DEBUG("Update TIB");
-      m_tib[id] = std::pair<Ptr<NetDevice>, Ptr<NetDevice>>(lasthop, rLasthop); // recorded nexthop is nullptr if this is destination, i.e., ground terminal
+      m_tib.Insert(id, std::pair<Ptr<NetDevice>, Ptr<NetDevice>>(lasthop, rLasthop)); // recorded nexthop is nullptr if this is destination, i.e., ground terminal
       NS_LOG_DEBUG("Purge PRT entry");
-      m_prt.erase(id);
+      m_prt.Erase(id);
+      if (rLasthop == nullptr) {
+        // the ground terminal may also have buffered data
+        StartFlush(id);
+      }
       break;
     }
     default:
@@ -209,7 +371,7 @@ HandoverManager::ProcessPacket(const ::nfd::face::Transport::Packet& packet, Ptr
 }
 
 void
-HandoverManager::BroadcastReq(string id, uint64_t hopLimit, Ptr<NetDevice> lasthop)
+HandoverManager::BroadcastReq(LinkId id, uint64_t hopLimit, Ptr<NetDevice> lasthop)
 {
   if (hopLimit == 0) {
     // sender of req, set to max hop limit
@@ -223,12 +385,10 @@ HandoverManager::BroadcastReq(string id, uint64_t hopLimit, Ptr<NetDevice> lasth
   NS_LOG_DEBUG("Broadcast req for " << id << ", remaining hops " << hopLimit - 1);
   core::TunnelReq req(id, hopLimit - 1);
   ::nfd::face::Transport::Packet packet(Block(req.wireEncode()));
-  auto& faces = m_ndn->getForwarder()->getFaceTable();
-  for (auto face = faces.begin(); face != faces.end(); face++) {
-    if (face->getScope() == ::ndn::nfd::FaceScope::FACE_SCOPE_LOCAL) {
-      continue;
-    }
-    auto transport = (UserLinkTransport*)(face->getTransport());
+  // ISLs and user links, app and internal faces are not indexed under this transport type
+  auto& faces = m_ndn->getFacesByTransportType(typeid(UserLinkTransport));
+  for (auto face : faces) {
+    auto transport = static_cast<UserLinkTransport*>(face->getTransport());
     if (transport->GetNetDevice() == lasthop || transport->m_isGone) {
       continue;
     }
@@ -237,15 +397,55 @@ HandoverManager::BroadcastReq(string id, uint64_t hopLimit, Ptr<NetDevice> lasth
     m_outReqs++;
   }
   if (lasthop == nullptr)
-    m_prt[id] = nullptr; // mark as destination in PRT
+    m_prt.Insert(id, nullptr); // mark as destination in PRT
 }
 
 void
-HandoverManager::AddUserLink(string id, ::nfd::FaceId faceId)
+HandoverManager::AddUserLink(LinkId id, ::nfd::FaceId faceId)
 {
   NS_LOG_DEBUG("record user link " << id << " " << faceId);
-  m_idList.push_back(id);
-  m_faceIdTable[id] = faceId;
+  m_idList.Insert(id, true);
+  m_faceIdTable.Insert(id, faceId);
+}
+
+void
+HandoverManager::RetireUserLink(LinkId id)
+{
+  Simulator::Schedule(m_userLinkLinger, &HandoverManager::RemoveUserLink, this, id);
+}
+
+Ptr<PointToPointNetDevice>
+HandoverManager::TakeFreeUserLinkDevice()
+{
+  if (m_freeUserLinkDevices.empty()) {
+    return nullptr;
+  }
+  auto device = m_freeUserLinkDevices.back();
+  m_freeUserLinkDevices.pop_back();
+  return device;
+}
+
+void
+HandoverManager::RemoveUserLink(LinkId id)
+{
+  auto faceId = m_faceIdTable.Find(id);
+  if (faceId == nullptr) {
+    return;
+  }
+  NS_LOG_DEBUG("close face " << *faceId << " of user link " << id);
+  // the face table removes the face from FIB and PIT, and L3Protocol from its indices
+  auto face = m_ndn->getForwarder()->getFaceTable().get(*faceId);
+  m_faceIdTable.Erase(id);
+  m_idList.Erase(id);
+  if (face == nullptr) {
+    return;
+  }
+  auto transport = dynamic_cast<UserLinkTransport*>(face->getTransport());
+  NS_ASSERT(transport != nullptr);
+  auto device = DynamicCast<PointToPointNetDevice>(transport->GetNetDevice());
+  face->close();
+  // the next user link on the device gets a new face, with a fresh ID and the URI of its peer
+  m_freeUserLinkDevices.push_back(device);
 }
 
 } // namespace sat
@@ -9,6 +9,7 @@
 #define SAT_OVERLAY_MANAGER_H
 
 #include "user-link-transport.hpp"
+#include "link-id-map.hpp"
 
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
@@ -16,28 +17,44 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/net-device.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
 
-#include <string>
-#include <map>
+#include <deque>
 #include <vector>
 
 namespace ns3{
 namespace ndn{
 namespace sat{
 
-using std::string;
-using std::map;
 using std::pair;
 using std::vector;
 
 using ::ndn::Block;
 
-typedef map<string, Ptr<NetDevice>> PtrTable;
-typedef map<string, pair<Ptr<NetDevice>, Ptr<NetDevice>>> TibTable;
-typedef map<string, nfd::FaceId> FaceIdTable;
-typedef vector<string> IdList;
+typedef LinkIdMap<Ptr<NetDevice>> PtrTable;
+typedef LinkIdMap<pair<Ptr<NetDevice>, Ptr<NetDevice>>> TibTable;
+typedef LinkIdMap<nfd::FaceId> FaceIdTable;
+typedef LinkIdMap<bool> IdList; // user links not yet reached by a req
 
-typedef map<string, vector<::nfd::face::Transport::Packet>> DataTable;
+/**
+ * @brief Packets waiting for a tunnel to be established, or to be flushed through it
+ */
+struct TunnelBuffer {
+  struct Entry {
+    ::nfd::face::Transport::Packet packet;
+    Time arrival;
+  };
+
+  std::deque<Entry> packets; // FIFO, oldest first
+  uint64_t nBytes = 0;
+  EventId expiryEvent; // fires when the oldest packet expires
+  EventId flushEvent; // next paced flush, running while the buffer is being flushed
+  Time flushStart;
+};
+
+typedef LinkIdMap<TunnelBuffer> DataTable;
 
 class HandoverManager : public Object {
 public:
@@ -62,14 +79,20 @@ public:
   Ptr<L3Protocol>
   GetL3Protocol() const;
 
+  /**
+   * @brief Allocate a new user link ID, unique within the simulation
+   */
+  static LinkId
+  AllocateLinkId();
+
   void
-  TunnelPacket(const nfd::face::Transport::Packet& packet, string tunnelId);
+  TunnelPacket(const nfd::face::Transport::Packet& packet, LinkId tunnelId);
 
   void
   ProcessPacket(const nfd::face::Transport::Packet& packet, Ptr<NetDevice> lasthop);
 
   void
-  BroadcastReq(string id, uint64_t hopLimit, Ptr<NetDevice> lasthop);
+  BroadcastReq(LinkId id, uint64_t hopLimit, Ptr<NetDevice> lasthop);
 
 protected:
   virtual void
@@ -78,14 +101,58 @@ protected:
 
 public:
   void
-  AddUserLink(string id, nfd::FaceId faceId);
+  AddUserLink(LinkId id, nfd::FaceId faceId);
+
+  /**
+   * @brief Close the face of a broken user link after UserLinkLinger, when tunnelled packets can no
+   *        longer be useful
+   *
+   * The device of the face then returns to the pool of free user link devices, and is bound to a
+   * later user link with a new face, so neither devices, channels nor faces pile up over handovers.
+   */
+  void
+  RetireUserLink(LinkId id);
+
+  /**
+   * @brief Take a user link device of a retired user link, with its channel, nullptr if none
+   */
+  Ptr<PointToPointNetDevice>
+  TakeFreeUserLinkDevice();
 
   bool
-  isInTib(string tunnelId)
+  isInTib(LinkId tunnelId)
   {
-    return !(m_tib.find(tunnelId) == m_tib.end());
+    return m_tib.Contains(tunnelId);
   }
 
+private:
+  void
+  SendPayload(const nfd::face::Transport::Packet& packet, LinkId tunnelId, Ptr<NetDevice> nexthop);
+
+  void
+  BufferPacket(const nfd::face::Transport::Packet& packet, LinkId tunnelId);
+
+  void
+  PopPacket(TunnelBuffer& buffer);
+
+  /**
+   * @brief Drop expired packets from the head of the buffer, reschedule the expiry timer
+   */
+  void
+  ExpireBuffer(LinkId tunnelId);
+
+  void
+  StartFlush(LinkId tunnelId);
+
+  /**
+   * @brief Send buffered packets while the outgoing device queue has room, then reschedule
+   */
+  void
+  FlushBuffer(LinkId tunnelId);
+
+  void
+  RemoveUserLink(LinkId id);
+
 public:
   uint64_t m_inReqs;
   uint64_t m_outReqs;
@@ -94,7 +161,21 @@ public:
   uint64_t m_inPayloads;
   uint64_t m_outPayloads;
 
+  // tunnel buffer counters
+  uint64_t m_overflowDrops; // dropped because the buffer of the tunnel exceeded MaxBufferBytes
+  uint64_t m_expiryDrops; // dropped because they were buffered longer than MaxBufferAge
+  uint64_t m_bufferedBytes; // bytes currently buffered in all tunnels
+  uint64_t m_peakBufferedBytes;
+  uint64_t m_flushes;
+  Time m_maxFlushLatency; // from establishment of a tunnel to the last buffered packet sent
+  Time m_totalFlushLatency;
+
 private:
+  uint64_t m_maxBufferBytes;
+  Time m_maxBufferAge;
+  uint64_t m_flushQueueBytes;
+  Time m_userLinkLinger;
+
   Ptr<L3Protocol> m_ndn;
 
   IdList m_idList;
@@ -103,6 +184,8 @@ private:
   TibTable m_tib;
   FaceIdTable m_faceIdTable;
 
+  vector<Ptr<PointToPointNetDevice>> m_freeUserLinkDevices;
+
   DataTable m_dt;
 
   TracedCallback<const nfd::Face&, const Block&> m_forwardPayload; ///< @brief trace of outgoing payload
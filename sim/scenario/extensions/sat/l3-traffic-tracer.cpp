@@ -31,8 +31,11 @@
 
 #include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
 #include "ns3/ndnSIM/NFD/daemon/table/pit-entry.hpp"
+#include "ns3/ndnSIM/NFD/daemon/table/name-tree-hashtable.hpp"
 
-#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include <boost/lexical_cast.hpp>
 
 NS_LOG_COMPONENT_DEFINE("ndn.sat.L3TrafficTracer");
@@ -45,7 +48,74 @@ using std::make_pair;
 
 const Name s_commonPrefix("/sin");
 
-static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<L3TrafficTracer>>>>
+/**
+ * @brief Name prefixes interned by all tracers, a prefix being a name minus its last component
+ *
+ * Prefixes are found by their NameTree hash and compared in place, so a packet name is copied
+ * only the first time its prefix is seen.
+ */
+class PrefixTable {
+public:
+  uint32_t
+  Intern(const Name& name)
+  {
+    size_t prefixLen = name.empty() ? 0 : name.size() - 1;
+    nfd::name_tree::HashValue hash = nfd::name_tree::computeHash(name, prefixLen);
+
+    if ((m_prefixes.size() + 1) * 2 > m_slots.size()) {
+      Grow();
+    }
+    size_t mask = m_slots.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+      uint32_t id = m_slots[i];
+      if (id == EMPTY) {
+        id = m_prefixes.size();
+        m_slots[i] = id;
+        m_prefixes.push_back(name.getPrefix(prefixLen));
+        m_hashes.push_back(hash);
+        return id;
+      }
+      if (m_hashes[id] == hash && name.compare(0, prefixLen, m_prefixes[id]) == 0) {
+        return id;
+      }
+    }
+  }
+
+  const Name&
+  Get(uint32_t id) const
+  {
+    return m_prefixes[id];
+  }
+
+private:
+  void
+  Grow()
+  {
+    m_slots.assign(m_slots.empty() ? 64 : m_slots.size() * 2, EMPTY);
+    size_t mask = m_slots.size() - 1;
+    for (uint32_t id = 0; id < m_prefixes.size(); id++) {
+      size_t i = m_hashes[id] & mask;
+      while (m_slots[i] != EMPTY) {
+        i = (i + 1) & mask;
+      }
+      m_slots[i] = id;
+    }
+  }
+
+private:
+  static const uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+  std::vector<uint32_t> m_slots; // prefix IDs, open addressing with linear probing
+  std::vector<Name> m_prefixes;
+  std::vector<nfd::name_tree::HashValue> m_hashes;
+};
+
+const uint32_t PrefixTable::EMPTY;
+
+// declared before g_tracers, so that prefixes outlive the tracers printing them
+static PrefixTable g_prefixes;
+
+static std::list<std::tuple<shared_ptr<TraceSink>, std::list<Ptr<L3TrafficTracer>>>>
   g_tracers;
 
 void
@@ -58,132 +128,81 @@ void
 L3TrafficTracer::InstallAll(const std::string& file)
 {
   std::list<Ptr<L3TrafficTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> sink = TraceSink::Open(file, GetColumns());
+  if (sink == nullptr) {
+    return;
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    Ptr<L3TrafficTracer> trace = Install(*node, outputStream);
+    Ptr<L3TrafficTracer> trace = Install(*node, sink);
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
-    // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
-  }
-
-  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+  g_tracers.push_back(std::make_tuple(sink, tracers));
 }
 
 void
 L3TrafficTracer::Install(const NodeContainer& nodes, const std::string& file)
 {
-  using namespace boost;
-  using namespace std;
-
   std::list<Ptr<L3TrafficTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> sink = TraceSink::Open(file, GetColumns());
+  if (sink == nullptr) {
+    return;
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
-    Ptr<L3TrafficTracer> trace = Install(*node, outputStream);
+    Ptr<L3TrafficTracer> trace = Install(*node, sink);
     tracers.push_back(trace);
   }
 
-  if (tracers.size() > 0) {
-    // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
-  }
-
-  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+  g_tracers.push_back(std::make_tuple(sink, tracers));
 }
 
 void
 L3TrafficTracer::Install(Ptr<Node> node, const std::string& file)
 {
-  using namespace boost;
-  using namespace std;
-
   std::list<Ptr<L3TrafficTracer>> tracers;
-  shared_ptr<std::ostream> outputStream;
-  if (file != "-") {
-    shared_ptr<std::ofstream> os(new std::ofstream());
-    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
-
-    if (!os->is_open()) {
-      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
-      return;
-    }
-
-    outputStream = os;
-  }
-  else {
-    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  shared_ptr<TraceSink> sink = TraceSink::Open(file, GetColumns());
+  if (sink == nullptr) {
+    return;
   }
 
-  Ptr<L3TrafficTracer> trace = Install(node, outputStream);
+  Ptr<L3TrafficTracer> trace = Install(node, sink);
   tracers.push_back(trace);
 
-  if (tracers.size() > 0) {
-    // *m_l3RateTrace << "# "; // not necessary for R's read.table
-    tracers.front()->PrintHeader(*outputStream);
-    *outputStream << "\n";
-  }
-
-  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+  g_tracers.push_back(std::make_tuple(sink, tracers));
 }
 
 Ptr<L3TrafficTracer>
-L3TrafficTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream)
+L3TrafficTracer::Install(Ptr<Node> node, shared_ptr<TraceSink> sink)
 {
   NS_LOG_DEBUG("Node: " << node->GetId());
 
-  Ptr<L3TrafficTracer> trace = Create<L3TrafficTracer>(outputStream, node);
+  Ptr<L3TrafficTracer> trace = Create<L3TrafficTracer>(sink, node);
 
   return trace;
 }
 
-L3TrafficTracer::L3TrafficTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
+L3TrafficTracer::L3TrafficTracer(shared_ptr<TraceSink> sink, Ptr<Node> node)
   : L3Tracer(node)
-  , m_os(os)
+  , m_sink(sink)
+  , m_hasTotals(false)
 {
+  m_totals.Reset();
+
   Ptr<::ns3::ndn::sat::HandoverManager> om = m_nodePtr->GetObject<::ns3::ndn::sat::HandoverManager>();
   if (om != nullptr) {
     om->TraceConnectWithoutContext("ForwardPayloads", MakeCallback(&L3TrafficTracer::ForwardPayloads, this));
   }
 }
 
-L3TrafficTracer::L3TrafficTracer(shared_ptr<std::ostream> os, const std::string& node)
+L3TrafficTracer::L3TrafficTracer(shared_ptr<TraceSink> sink, const std::string& node)
   : L3Tracer(node)
-  , m_os(os)
+  , m_sink(sink)
+  , m_hasTotals(false)
 {
+  m_totals.Reset();
+
   Ptr<::ns3::ndn::sat::HandoverManager> om = m_nodePtr->GetObject<::ns3::ndn::sat::HandoverManager>();
   if (om != nullptr) {
     om->TraceConnectWithoutContext("ForwardPayloads", MakeCallback(&L3TrafficTracer::ForwardPayloads, this));
@@ -192,67 +211,97 @@ L3TrafficTracer::L3TrafficTracer(shared_ptr<std::ostream> os, const std::string&
 
 L3TrafficTracer::~L3TrafficTracer()
 {
-  Print(*m_os);
+  Write(*m_sink);
+}
+
+const TraceSink::Columns&
+L3TrafficTracer::GetColumns()
+{
+  static const TraceSink::Columns columns = {
+    {"Node", TraceSink::STRING},
+    {"FaceId", TraceSink::INTEGER},
+    {"FaceDescr", TraceSink::STRING},
+
+    {"Prefix", TraceSink::STRING}, // full name minus last component, show for only "/sin" names
+
+    {"Type", TraceSink::STRING},
+    {"Packets", TraceSink::REAL},
+    {"Kilobytes", TraceSink::REAL},
+  };
+  return columns;
 }
 
 void
 L3TrafficTracer::PrintHeader(std::ostream& os) const
 {
-  os << "Node"
-     << "\t"
-     << "FaceId"
-     << "\t"
-     << "FaceDescr"
-     << "\t"
-
-     << "Prefix" // full name minus last component, show for only "/sin" names
-     << "\t"
-
-     << "Type"
-     << "\t"
-     << "Packets"
-     << "\t"
-     << "Kilobytes"
-     << "\t"
-     << "PacketRaw"
-     << "\t"
-     << "KilobytesRaw";
+  const char* separator = "";
+  for (const auto& column : GetColumns()) {
+    os << separator << column.name;
+    separator = "\t";
+  }
 }
 
 void
 L3TrafficTracer::Reset()
 {
   for (auto& stats : m_stats) {
-    std::get<0>(stats.second).Reset();
-    std::get<1>(stats.second).Reset();
+    stats.packets.Reset();
+    stats.bytes.Reset();
   }
+  m_totals.Reset();
 }
 
 const double alpha = 0.8;
 
-#define STATS(INDEX) std::get<INDEX>(stats.second)
-
 #define PRINTER(printName, fieldName)                                                              \
-  os << m_node << "\t";                                                                            \
-  if (stats.first.first != nfd::face::INVALID_FACEID) {                                            \
-    os << stats.first.first << "\t";                                                               \
-    NS_ASSERT(m_faceInfos.find(stats.first.first) != m_faceInfos.end());                           \
-    os << m_faceInfos.find(stats.first.first)->second << "\t";                                     \
-    os << stats.first.second << "\t";                                                              \
-  }                                                                                                \
-  else {                                                                                           \
-    os << "-1\tall\t/\t";                                                                          \
-  }                                                                                                \
-  os << printName << "\t" << STATS(0).fieldName << "\t" << STATS(1).fieldName / 1024.0 << "\n";
+  sink.AddString(m_node);                                                                          \
+  sink.AddInteger(stats->faceId);                                                                  \
+  sink.AddString(faceInfo);                                                                        \
+  sink.AddString(prefix);                                                                          \
+  sink.AddString(printName);                                                                       \
+  sink.AddReal(stats->packets.fieldName);                                                          \
+  sink.AddReal(stats->bytes.fieldName / 1024.0);                                                   \
+  sink.EndRecord();
+
+#define TOTALS_PRINTER(printName, fieldName)                                                       \
+  sink.AddString(m_node);                                                                          \
+  sink.AddInteger(-1);                                                                             \
+  sink.AddString("all");                                                                           \
+  sink.AddString("/");                                                                             \
+  sink.AddString(printName);                                                                       \
+  sink.AddReal(m_totals.fieldName);                                                                \
+  sink.AddReal(0);                                                                                 \
+  sink.EndRecord();
 
 void
 L3TrafficTracer::Print(std::ostream& os) const
 {
-  Time time = Simulator::Now();
+  TextTraceSink sink(shared_ptr<std::ostream>(&os, std::bind([]{})), GetColumns(), false);
+  Write(sink);
+}
 
-  for (auto& stats : m_stats) {
-    if (stats.first.first == nfd::face::INVALID_FACEID)
-      continue;
+void
+L3TrafficTracer::Write(TraceSink& sink) const
+{
+  // snapshot ordered by face and prefix, counters are not touched while it is written
+  std::vector<const FaceStats*> snapshot;
+  snapshot.reserve(m_stats.size());
+  for (const auto& stats : m_stats) {
+    if (stats.faceId != nfd::face::INVALID_FACEID) {
+      snapshot.push_back(&stats);
+    }
+  }
+  std::sort(snapshot.begin(), snapshot.end(), [] (const FaceStats* a, const FaceStats* b) {
+      if (a->faceId != b->faceId) {
+        return a->faceId < b->faceId;
+      }
+      return g_prefixes.Get(a->prefixId) < g_prefixes.Get(b->prefixId);
+    });
+
+  for (const FaceStats* stats : snapshot) {
+    NS_ASSERT(m_faceInfos.find(stats->faceId) != m_faceInfos.end());
+    const std::string& faceInfo = m_faceInfos.find(stats->faceId)->second;
+    std::string prefix = g_prefixes.Get(stats->prefixId).toUri();
 
     PRINTER("InInterests", m_inInterests);
     PRINTER("OutInterests", m_outInterests);
@@ -270,139 +319,138 @@ L3TrafficTracer::Print(std::ostream& os) const
     PRINTER("OutTimedOutInterests", m_outTimedOutInterests);
   }
 
-  {
-    auto i = m_stats.find(make_pair(nfd::face::INVALID_FACEID, Name("/")));
-    if (i != m_stats.end()) {
-      auto& stats = *i;
-      PRINTER("SatisfiedInterests", m_satisfiedInterests);
-      PRINTER("TimedOutInterests", m_timedOutInterests);
-    }
+  if (m_hasTotals) {
+    TOTALS_PRINTER("SatisfiedInterests", m_satisfiedInterests);
+    TOTALS_PRINTER("TimedOutInterests", m_timedOutInterests);
+  }
+}
+
+L3TrafficTracer::FaceStats&
+L3TrafficTracer::GetStats(const Face& face, const Name& name)
+{
+  uint32_t prefixId = g_prefixes.Intern(name);
+  NS_ASSERT(face.getId() <= std::numeric_limits<uint32_t>::max());
+  LinkId key = (static_cast<LinkId>(face.getId()) << 32) | (prefixId + 1); // never INVALID_LINK_ID
+
+  uint32_t* index = m_statsIndices.Find(key);
+  if (index != nullptr) {
+    return m_stats[*index];
   }
+
+  AddInfo(face);
+  m_statsIndices.Insert(key, m_stats.size());
+  m_stats.push_back(FaceStats());
+  FaceStats& stats = m_stats.back();
+  stats.faceId = face.getId();
+  stats.prefixId = prefixId;
+  stats.packets.Reset();
+  stats.bytes.Reset();
+  return stats;
 }
 
 void
 L3TrafficTracer::OutInterests(const Interest& interest, const Face& face)
 {
-  AddInfo(face);
-  auto index = make_pair(face.getId(), interest.getName().getPrefix(-1));
-  std::get<0>(m_stats[index]).m_outInterests++;
+  FaceStats& stats = GetStats(face, interest.getName());
+  stats.packets.m_outInterests++;
   if (interest.hasWire()) {
-    std::get<1>(m_stats[index]).m_outInterests +=
-      interest.wireEncode().size();
+    stats.bytes.m_outInterests += interest.wireEncode().size();
   }
 }
 
 void
 L3TrafficTracer::InInterests(const Interest& interest, const Face& face)
 {
-  AddInfo(face);
-  auto index = make_pair(face.getId(), interest.getName().getPrefix(-1));
-  std::get<0>(m_stats[index]).m_inInterests++;
+  FaceStats& stats = GetStats(face, interest.getName());
+  stats.packets.m_inInterests++;
   if (interest.hasWire()) {
-    std::get<1>(m_stats[index]).m_inInterests +=
-      interest.wireEncode().size();
+    stats.bytes.m_inInterests += interest.wireEncode().size();
   }
 }
 
 void
 L3TrafficTracer::OutData(const Data& data, const Face& face)
 {
-  AddInfo(face);
-  auto index = make_pair(face.getId(), data.getName().getPrefix(-1));
-  std::get<0>(m_stats[index]).m_outData++;
+  FaceStats& stats = GetStats(face, data.getName());
+  stats.packets.m_outData++;
   if (data.hasWire()) {
-    std::get<1>(m_stats[index]).m_outData +=
-      data.wireEncode().size();
+    stats.bytes.m_outData += data.wireEncode().size();
   }
 }
 
 void
 L3TrafficTracer::InData(const Data& data, const Face& face)
 {
-  AddInfo(face);
-  auto index = make_pair(face.getId(), data.getName().getPrefix(-1));
-  std::get<0>(m_stats[index]).m_inData++;
+  FaceStats& stats = GetStats(face, data.getName());
+  stats.packets.m_inData++;
   if (data.hasWire()) {
-    std::get<1>(m_stats[index]).m_inData +=
-      data.wireEncode().size();
+    stats.bytes.m_inData += data.wireEncode().size();
   }
 }
 
 void
 L3TrafficTracer::OutNack(const lp::Nack& nack, const Face& face)
 {
-  AddInfo(face);
-  auto index = make_pair(face.getId(), nack.getInterest().getName().getPrefix(-1));
-  std::get<0>(m_stats[index]).m_outNack++;
+  FaceStats& stats = GetStats(face, nack.getInterest().getName());
+  stats.packets.m_outNack++;
   if (nack.getInterest().hasWire()) {
-    std::get<1>(m_stats[index]).m_outNack +=
-      nack.getInterest().wireEncode().size();
+    stats.bytes.m_outNack += nack.getInterest().wireEncode().size();
   }
 }
 
 void
 L3TrafficTracer::InNack(const lp::Nack& nack, const Face& face)
 {
-  AddInfo(face);
-  auto index = make_pair(face.getId(), nack.getInterest().getName().getPrefix(-1));
-  std::get<0>(m_stats[index]).m_inNack++;
+  FaceStats& stats = GetStats(face, nack.getInterest().getName());
+  stats.packets.m_inNack++;
   if (nack.getInterest().hasWire()) {
-    std::get<1>(m_stats[index]).m_inNack +=
-      nack.getInterest().wireEncode().size();
+    stats.bytes.m_inNack += nack.getInterest().wireEncode().size();
   }
 }
 
 void
 L3TrafficTracer::SatisfiedInterests(const nfd::pit::Entry& entry, const Face&, const Data&)
 {
-  std::get<0>(m_stats[make_pair(nfd::face::INVALID_FACEID, Name("/"))]).m_satisfiedInterests++;
+  m_totals.m_satisfiedInterests++;
+  m_hasTotals = true;
   // no "size" stats
 
   for (const auto& in : entry.getInRecords()) {
-    AddInfo(in.getFace());
-    auto index = make_pair((in.getFace()).getId(), entry.getName().getPrefix(-1));
-    std::get<0>(m_stats[index]).m_satisfiedInterests ++;
+    GetStats(in.getFace(), entry.getName()).packets.m_satisfiedInterests++;
   }
 
   for (const auto& out : entry.getOutRecords()) {
-    AddInfo(out.getFace());
-    auto index = make_pair((out.getFace()).getId(), entry.getName().getPrefix(-1));
-    std::get<0>(m_stats[index]).m_outSatisfiedInterests ++;
+    GetStats(out.getFace(), entry.getName()).packets.m_outSatisfiedInterests++;
   }
 }
 
 void
 L3TrafficTracer::TimedOutInterests(const nfd::pit::Entry& entry)
 {
-  std::get<0>(m_stats[make_pair(nfd::face::INVALID_FACEID, Name("/"))]).m_timedOutInterests++;
+  m_totals.m_timedOutInterests++;
+  m_hasTotals = true;
   // no "size" stats
 
   for (const auto& in : entry.getInRecords()) {
-    AddInfo(in.getFace());
-    auto index = make_pair((in.getFace()).getId(), entry.getName().getPrefix(-1));
-    std::get<0>(m_stats[index]).m_timedOutInterests++;
+    GetStats(in.getFace(), entry.getName()).packets.m_timedOutInterests++;
   }
 
   for (const auto& out : entry.getOutRecords()) {
-    AddInfo(out.getFace());
-    auto index = make_pair((out.getFace()).getId(), entry.getName().getPrefix(-1));
-    std::get<0>(m_stats[index]).m_outTimedOutInterests++;
+    GetStats(out.getFace(), entry.getName()).packets.m_outTimedOutInterests++;
   }
 }
 
 void
 L3TrafficTracer::ForwardPayloads(const Face& face, const ndn::Block& payload)
 {
-  AddInfo(face);
+  // only the name is decoded, the rest of the payload is not needed
   if (payload.type() == ::ndn::tlv::Interest) {
-    Interest interest(payload);
-    auto index = make_pair(face.getId(), interest.getName().getPrefix(-1));
-    std::get<0>(m_stats[index]).m_outInterests++;
+    payload.parse();
+    GetStats(face, Name(payload.get(::ndn::tlv::Name))).packets.m_outInterests++;
   }
   else if (payload.type() == ::ndn::tlv::Data) {
-    Data data(payload);
-    auto index = make_pair(face.getId(), data.getName().getPrefix(-1));
-    std::get<0>(m_stats[index]).m_outData++;
+    payload.parse();
+    GetStats(face, Name(payload.get(::ndn::tlv::Name))).packets.m_outData++;
   }
 }
 
@@ -23,6 +23,9 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/utils/tracers/ndn-l3-tracer.hpp"
 
+#include "link-id-map.hpp"
+#include "trace-sink.hpp"
+
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/node-container.h"
@@ -30,6 +33,7 @@
 #include <map>
 #include <list>
 #include <tuple>
+#include <vector>
 
 namespace ns3 {
 namespace ndn {
@@ -81,17 +85,17 @@ public:
 
   /**
    * @brief Trace constructor that attaches to the node using node pointer
-   * @param os    reference to the output stream
+   * @param sink  sink to which counters are written when the tracer is destroyed
    * @param node  pointer to the node
    */
-  L3TrafficTracer(shared_ptr<std::ostream> os, Ptr<Node> node);
+  L3TrafficTracer(shared_ptr<TraceSink> sink, Ptr<Node> node);
 
   /**
    * @brief Trace constructor that attaches to the node using node name
-   * @param os        reference to the output stream
+   * @param sink      sink to which counters are written when the tracer is destroyed
    * @param nodeName  name of the node registered using Names::Add
    */
-  L3TrafficTracer(shared_ptr<std::ostream> os, const std::string& node);
+  L3TrafficTracer(shared_ptr<TraceSink> sink, const std::string& node);
 
   /**
    * @brief Destructor
@@ -102,14 +106,20 @@ public:
    * @brief Helper method to install tracers on a specific simulation node
    *
    * @param nodes Nodes on which to install tracer
-   * @param outputStream Smart pointer to a stream
+   * @param sink Sink of the records, its header is not written by the tracer
    *
    * @returns a tuple of reference to output stream and list of tracers. !!! Attention !!! This
    *tuple needs to be preserved
    *          for the lifetime of simulation, otherwise SEGFAULTs are inevitable
    */
   static Ptr<L3TrafficTracer>
-  Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream);
+  Install(Ptr<Node> node, shared_ptr<TraceSink> sink);
+
+  /**
+   * @brief Columns of the trace (e.g., for post-processing)
+   */
+  static const TraceSink::Columns&
+  GetColumns();
 
   // from L3Tracer
   virtual void
@@ -148,17 +158,38 @@ protected:
   ForwardPayloads(const Face&, const ndn::Block&);
 
 private:
+  /**
+   * @brief Packet and byte counters of a face for a name prefix (name minus last component)
+   */
+  struct FaceStats {
+    nfd::FaceId faceId;
+    uint32_t prefixId; // interned, see l3-traffic-tracer.cpp
+    Stats packets;
+    Stats bytes;
+  };
 
   void
   Reset();
 
+  void
+  Write(TraceSink& sink) const;
+
+  /**
+   * @brief Get the counters of face for the prefix of name, creating them on first use
+   */
+  FaceStats&
+  GetStats(const Face& face, const Name& name);
+
   void
   AddInfo(const Face& face);
 
 private:
-  shared_ptr<std::ostream> m_os;
+  shared_ptr<TraceSink> m_sink;
 
-  mutable std::map<std::pair<nfd::FaceId, Name>, std::tuple<Stats, Stats, Stats, Stats>> m_stats;
+  std::vector<FaceStats> m_stats;
+  LinkIdMap<uint32_t> m_statsIndices; // (face ID, prefix ID) packed in 64 bits -> index in m_stats
+  Stats m_totals; // satisfied and timed out Interests of the node
+  bool m_hasTotals;
   std::map<nfd::FaceId, std::string> m_faceInfos; // needed, because face may no longer exists at the time of stat printing
 };
 
@@ -0,0 +1,197 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_LINK_ID_MAP_HPP
+#define SAT_LINK_ID_MAP_HPP
+
+#include <boost/assert.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+/**
+ * @brief Numeric identifier of a user link, also used as tunnel ID, 0 means no link
+ */
+typedef uint64_t LinkId;
+
+const LinkId INVALID_LINK_ID = 0;
+
+/**
+ * @brief Open-addressing hash map keyed by link IDs
+ *
+ * Linear probing over a power-of-two table, with backward-shift deletion so no tombstones are
+ * left behind.  Lookups and updates do not allocate once the table has grown to its working size.
+ * Pointers returned by Find are invalidated by Insert and Erase.
+ */
+template<typename T>
+class LinkIdMap {
+public:
+  LinkIdMap()
+    : m_size(0)
+  {
+  }
+
+  size_t
+  Size() const
+  {
+    return m_size;
+  }
+
+  bool
+  Contains(LinkId id) const
+  {
+    return Find(id) != nullptr;
+  }
+
+  T*
+  Find(LinkId id)
+  {
+    return const_cast<T*>(static_cast<const LinkIdMap&>(*this).Find(id));
+  }
+
+  const T*
+  Find(LinkId id) const
+  {
+    if (m_slots.empty()) {
+      return nullptr;
+    }
+    for (size_t i = Home(id); ; i = Next(i)) {
+      if (m_slots[i].first == id) {
+        return &m_slots[i].second;
+      }
+      if (m_slots[i].first == INVALID_LINK_ID) {
+        return nullptr;
+      }
+    }
+  }
+
+  /**
+   * @brief Get the value for id, inserting a default-constructed value if there is none
+   */
+  T&
+  operator[](LinkId id)
+  {
+    T* value = Find(id);
+    if (value != nullptr) {
+      return *value;
+    }
+    return Insert(id, T());
+  }
+
+  /**
+   * @brief Insert or replace the value for id
+   */
+  T&
+  Insert(LinkId id, T value)
+  {
+    BOOST_ASSERT(id != INVALID_LINK_ID);
+    T* existing = Find(id);
+    if (existing != nullptr) {
+      *existing = std::move(value);
+      return *existing;
+    }
+
+    // keep the load factor at most 1/2
+    if ((m_size + 1) * 2 > m_slots.size()) {
+      Grow();
+    }
+    size_t i = Home(id);
+    while (m_slots[i].first != INVALID_LINK_ID) {
+      i = Next(i);
+    }
+    m_slots[i].first = id;
+    m_slots[i].second = std::move(value);
+    m_size++;
+    return m_slots[i].second;
+  }
+
+  bool
+  Erase(LinkId id)
+  {
+    if (m_slots.empty()) {
+      return false;
+    }
+    size_t i = Home(id);
+    while (m_slots[i].first != id) {
+      if (m_slots[i].first == INVALID_LINK_ID) {
+        return false;
+      }
+      i = Next(i);
+    }
+
+    // shift back following entries of the probe sequence, so that lookups need no tombstones
+    size_t hole = i;
+    for (size_t j = Next(hole); m_slots[j].first != INVALID_LINK_ID; j = Next(j)) {
+      size_t home = Home(m_slots[j].first);
+      // move entry j into the hole unless its home lies cyclically in (hole, j]
+      bool isBetween = hole < j ? (hole < home && home <= j) : (hole < home || home <= j);
+      if (!isBetween) {
+        m_slots[hole] = std::move(m_slots[j]);
+        hole = j;
+      }
+    }
+    m_slots[hole].first = INVALID_LINK_ID;
+    m_slots[hole].second = T();
+    m_size--;
+    return true;
+  }
+
+  void
+  Clear()
+  {
+    m_slots.clear();
+    m_size = 0;
+  }
+
+private:
+  size_t
+  Home(LinkId id) const
+  {
+    // Fibonacci hashing spreads sequentially allocated IDs over the table
+    return static_cast<size_t>((id * 0x9E3779B97F4A7C15ULL) >> 32) & (m_slots.size() - 1);
+  }
+
+  size_t
+  Next(size_t i) const
+  {
+    return (i + 1) & (m_slots.size() - 1);
+  }
+
+  void
+  Grow()
+  {
+    std::vector<std::pair<LinkId, T>> old;
+    old.swap(m_slots);
+    m_slots.resize(old.empty() ? 16 : old.size() * 2);
+    for (auto& slot : old) {
+      if (slot.first == INVALID_LINK_ID) {
+        continue;
+      }
+      size_t i = Home(slot.first);
+      while (m_slots[i].first != INVALID_LINK_ID) {
+        i = Next(i);
+      }
+      m_slots[i] = std::move(slot);
+    }
+  }
+
+private:
+  std::vector<std::pair<LinkId, T>> m_slots; // key INVALID_LINK_ID marks an empty slot
+  size_t m_size;
+};
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_LINK_ID_MAP_HPP
@@ -0,0 +1,167 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "partition.hpp"
+#include "grid-strategy.hpp"
+
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "ns3/point-to-point-helper.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif // NS3_MPI
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.Partition");
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+uint32_t
+GetNRanks()
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled()) {
+    return MpiInterface::GetSize();
+  }
+#endif // NS3_MPI
+  return 1;
+}
+
+uint32_t
+GetRank()
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled()) {
+    return MpiInterface::GetSystemId();
+  }
+#endif // NS3_MPI
+  return 0;
+}
+
+bool
+IsLocalNode(Ptr<Node> node)
+{
+  return GetNRanks() == 1 || node->GetSystemId() == GetRank();
+}
+
+vector<uint32_t>
+AssignSatelliteRanks(const vector<string>& satNames, uint32_t nRanks)
+{
+  vector<uint32_t> ranks(satNames.size(), 0);
+  if (nRanks <= 1) {
+    return ranks;
+  }
+
+  vector<int> orbits(satNames.size(), -1);
+  int nPlanes = 0;
+  for (size_t i = 0; i < satNames.size(); i++) {
+    nfd::fw::GridCoord coord;
+    if (nfd::fw::GridStrategy::parseSatName(satNames[i], coord)) {
+      orbits[i] = coord.orbit;
+      nPlanes = std::max(nPlanes, coord.orbit + 1);
+    }
+  }
+  if (nPlanes > 0 && static_cast<uint32_t>(nPlanes) < nRanks) {
+    NS_FATAL_ERROR("Cannot partition " << nPlanes << " orbital planes over " << nRanks << " ranks");
+  }
+
+  for (size_t i = 0; i < satNames.size(); i++) {
+    if (orbits[i] >= 0) {
+      ranks[i] = static_cast<uint64_t>(orbits[i]) * nRanks / nPlanes;
+    }
+    else {
+      ranks[i] = static_cast<uint64_t>(i) * nRanks / satNames.size();
+    }
+  }
+  return ranks;
+}
+
+uint32_t
+AssignStationRank(const vector<pair<double, int>>& attachments, const vector<uint32_t>& satRanks)
+{
+  for (auto& att : attachments) {
+    if (att.second >= 0) {
+      return satRanks.at(att.second);
+    }
+  }
+  return 0;
+}
+
+Time
+GetMinCrossRankDelay(const NodeRegistry& registry, const LinkDelays& linkDelays)
+{
+  // user links start with the default delay, and keep it while the delay table has no entry
+  TypeId::AttributeInformation info;
+  PointToPointChannel::GetTypeId().LookupAttributeByName("Delay", &info);
+  Time minDelay = DynamicCast<const TimeValue>(info.initialValue)->Get();
+
+  for (size_t i = 0; i < linkDelays.islChannels.size(); i++) {
+    auto channel = linkDelays.islChannels[i];
+    if (channel->GetDevice(0)->GetNode()->GetSystemId() == channel->GetDevice(1)->GetNode()->GetSystemId()) {
+      continue;
+    }
+    TimeValue delay;
+    channel->GetAttribute("Delay", delay);
+    minDelay = std::min(minDelay, delay.Get());
+    for (auto& epoch : linkDelays.islDelays) {
+      minDelay = std::min(minDelay, MicroSeconds(epoch.second[i]));
+    }
+  }
+
+  for (auto& station : registry.stations) {
+    for (auto delay : station.userLinkDelays) {
+      if (delay > 0) {
+        minDelay = std::min(minDelay, MicroSeconds(delay));
+      }
+    }
+  }
+
+  NS_LOG_INFO("Minimum cross-rank delay: " << minDelay.GetMicroSeconds() << "us");
+  return minDelay;
+}
+
+void
+InstallLookaheadLinks(const NodeRegistry& registry, Time lookahead)
+{
+  uint32_t nRanks = GetNRanks();
+  if (nRanks <= 1) {
+    return;
+  }
+
+  vector<Ptr<Node>> firstSats(nRanks);
+  for (auto& sat : registry.satellites) {
+    auto rank = sat.node->GetSystemId();
+    if (rank < nRanks && firstSats[rank] == nullptr) {
+      firstSats[rank] = sat.node;
+    }
+  }
+  for (uint32_t rank = 0; rank < nRanks; rank++) {
+    if (firstSats[rank] == nullptr) {
+      NS_FATAL_ERROR("No satellite is simulated by rank " << rank);
+    }
+  }
+
+  // devices of PointToPointHelper get a remote channel, and receivers, as the nodes are on different ranks
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute("Delay", TimeValue(lookahead));
+  for (uint32_t rank = 0; rank < nRanks; rank++) {
+    uint32_t next = (rank + 1) % nRanks;
+    if (nRanks == 2 && next == 0) {
+      break;
+    }
+    p2p.Install(firstSats[rank], firstSats[next]);
+  }
+  NS_LOG_INFO("Installed lookahead links of " << lookahead.GetMicroSeconds() << "us between " << nRanks << " ranks");
+}
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
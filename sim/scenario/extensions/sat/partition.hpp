@@ -0,0 +1,83 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_PARTITION_HPP
+#define SAT_PARTITION_HPP
+
+#include "common.hpp"
+
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+/**
+ * @brief Number of ranks of the distributed (MPI) simulation, 1 if it is not distributed
+ */
+uint32_t
+GetNRanks();
+
+/**
+ * @brief Rank of this process in the distributed simulation, 0 if it is not distributed
+ */
+uint32_t
+GetRank();
+
+/**
+ * @brief Whether events of node are simulated by this rank
+ *
+ * Every rank creates all nodes, links and NDN stacks, and runs the scenario updates on all of
+ * them, but only installs apps and tracers on its own nodes, which are the only ones packets
+ * are sent from.
+ */
+bool
+IsLocalNode(Ptr<Node> node);
+
+/**
+ * @brief Rank of each satellite, by contiguous orbital planes
+ *
+ * Each rank gets a block of about nPlanes/nRanks neighbor planes, planes being taken from the
+ * satellite names (see getSatId in Leo.py). ISLs within a plane and between neighbor planes of
+ * a block then stay on one rank, only the ISLs between the border planes of two blocks cross
+ * ranks. Satellites not named after their position are spread over the ranks by index.
+ * Aborts the simulation if there are fewer planes than ranks.
+ */
+vector<uint32_t>
+AssignSatelliteRanks(const vector<string>& satNames, uint32_t nRanks);
+
+/**
+ * @brief Rank of a station, that of the first satellite it attaches to, 0 if it never attaches
+ */
+uint32_t
+AssignStationRank(const vector<pair<double, int>>& attachments, const vector<uint32_t>& satRanks);
+
+/**
+ * @brief Smallest delay any link between nodes of different ranks may have during the run
+ *
+ * Takes cross-rank ISLs at all epochs of linkDelays, and user links of all stations at all
+ * epochs, as any station may attach to a satellite of another rank.
+ */
+Time
+GetMinCrossRankDelay(const NodeRegistry& registry, const LinkDelays& linkDelays);
+
+/**
+ * @brief Link the first satellites of neighbor ranks in a ring, with links of delay lookahead
+ *
+ * The distributed simulator takes its lookahead from the delays of the links between ranks when
+ * it starts running. ISL delays change with the epochs and user links between ranks are created
+ * on handovers, so links that always have the smallest delay bound the lookahead. They carry no
+ * traffic, as they are created after the NDN stacks and thus have no faces.
+ */
+void
+InstallLookaheadLinks(const NodeRegistry& registry, Time lookahead);
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_PARTITION_HPP
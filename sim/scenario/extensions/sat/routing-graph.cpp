@@ -0,0 +1,181 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "routing-graph.hpp"
+
+#include "ns3/ndnSIM/NFD/daemon/face/face.hpp"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/node-list.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.RoutingGraph");
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+const uint32_t RoutingGraph::UNREACHABLE;
+
+// children of heap slot i are 4i+1 .. 4i+4
+static const uint32_t HEAP_ARITY = 4;
+
+RoutingGraph::RoutingGraph()
+{
+  std::unordered_map<uint32_t, uint32_t> vertices; // GlobalRouter ID -> vertex
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    Ptr<GlobalRouter> router = (*node)->GetObject<GlobalRouter>();
+    if (router == 0) {
+      continue;
+    }
+    vertices[router->GetId()] = m_routers.size();
+    m_routers.push_back(router);
+    m_nodes.push_back(*node);
+  }
+
+  m_offsets.reserve(m_routers.size() + 1);
+  m_offsets.push_back(0);
+  for (const auto& router : m_routers) {
+    for (const auto& incidency : router->GetIncidencies()) {
+      const auto& face = std::get<1>(incidency);
+      auto target = vertices.find(std::get<2>(incidency)->GetId());
+      if (face == nullptr || target == vertices.end()) {
+        continue; // multi-access links are not added
+      }
+      m_targets.push_back(target->second);
+      m_metrics.push_back(static_cast<uint16_t>(face->getMetric()));
+      m_faces.push_back(face);
+    }
+    m_offsets.push_back(m_targets.size());
+  }
+
+  m_distances.resize(m_routers.size());
+  m_firstHops.resize(m_routers.size());
+  m_heap.reserve(m_routers.size());
+  m_heapPositions.assign(m_routers.size(), -1);
+
+  NS_LOG_DEBUG("Routing graph with " << GetNVertices() << " vertices and " << GetNEdges() << " edges");
+}
+
+void
+RoutingGraph::RefreshMetrics()
+{
+  for (uint32_t e = 0; e < GetNEdges(); e++) {
+    m_metrics[e] = static_cast<uint16_t>(m_faces[e]->getMetric());
+  }
+}
+
+void
+RoutingGraph::ShortestPaths(uint32_t source, int32_t firstEdge)
+{
+  NS_ASSERT(source < GetNVertices());
+  std::fill(m_distances.begin(), m_distances.end(), UNREACHABLE);
+  std::fill(m_firstHops.begin(), m_firstHops.end(), -1);
+
+  m_distances[source] = 0;
+  HeapPush(source);
+  while (!m_heap.empty()) {
+    uint32_t u = HeapPop();
+    uint32_t begin = m_offsets[u];
+    uint32_t end = m_offsets[u+1];
+    if (u == source && firstEdge >= 0) {
+      NS_ASSERT(begin <= static_cast<uint32_t>(firstEdge) && static_cast<uint32_t>(firstEdge) < end);
+      begin = firstEdge;
+      end = firstEdge + 1;
+    }
+    for (uint32_t e = begin; e < end; e++) {
+      uint32_t v = m_targets[e];
+      uint32_t distance = m_distances[u] + m_metrics[e];
+      if (distance >= m_distances[v]) {
+        continue;
+      }
+      m_distances[v] = distance;
+      m_firstHops[v] = u == source ? static_cast<int32_t>(e) : m_firstHops[u];
+      if (m_heapPositions[v] < 0) {
+        HeapPush(v);
+      }
+      else {
+        HeapSiftUp(m_heapPositions[v]);
+      }
+    }
+  }
+}
+
+void
+RoutingGraph::HeapPush(uint32_t v)
+{
+  m_heapPositions[v] = m_heap.size();
+  m_heap.push_back(v);
+  HeapSiftUp(m_heap.size() - 1);
+}
+
+uint32_t
+RoutingGraph::HeapPop()
+{
+  uint32_t top = m_heap.front();
+  m_heapPositions[top] = -1;
+  uint32_t last = m_heap.back();
+  m_heap.pop_back();
+  if (!m_heap.empty()) {
+    m_heap[0] = last;
+    m_heapPositions[last] = 0;
+    HeapSiftDown(0);
+  }
+  return top;
+}
+
+void
+RoutingGraph::HeapSiftUp(uint32_t i)
+{
+  uint32_t v = m_heap[i];
+  while (i > 0) {
+    uint32_t parent = (i - 1) / HEAP_ARITY;
+    if (m_distances[m_heap[parent]] <= m_distances[v]) {
+      break;
+    }
+    m_heap[i] = m_heap[parent];
+    m_heapPositions[m_heap[i]] = i;
+    i = parent;
+  }
+  m_heap[i] = v;
+  m_heapPositions[v] = i;
+}
+
+void
+RoutingGraph::HeapSiftDown(uint32_t i)
+{
+  uint32_t v = m_heap[i];
+  uint32_t size = m_heap.size();
+  while (true) {
+    uint32_t first = i * HEAP_ARITY + 1;
+    if (first >= size) {
+      break;
+    }
+    uint32_t best = first;
+    uint32_t last = std::min(first + HEAP_ARITY, size);
+    for (uint32_t child = first + 1; child < last; child++) {
+      if (m_distances[m_heap[child]] < m_distances[m_heap[best]]) {
+        best = child;
+      }
+    }
+    if (m_distances[m_heap[best]] >= m_distances[v]) {
+      break;
+    }
+    m_heap[i] = m_heap[best];
+    m_heapPositions[m_heap[i]] = i;
+    i = best;
+  }
+  m_heap[i] = v;
+  m_heapPositions[v] = i;
+}
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_ROUTING_GRAPH_HPP
+#define SAT_ROUTING_GRAPH_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+
+#include "ns3/node.h"
+#include "ns3/ptr.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+using std::vector;
+
+/**
+ * @brief Compressed sparse row snapshot of the GlobalRouter incidencies of all nodes
+ *
+ * Vertices are numbered in NodeList order, and the out-edges of vertex v are [EdgesBegin(v),
+ * EdgesEnd(v)), each with its target vertex, face and face metric.  Shortest paths are computed
+ * with an indexed 4-ary heap over flat arrays that are reused across sources, so running Dijkstra
+ * from every vertex does not allocate nor touch any reference count.
+ *
+ * The snapshot has to be rebuilt when incidencies change; face metrics can be reloaded with
+ * RefreshMetrics.
+ */
+class RoutingGraph {
+public:
+  static const uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @brief Take a snapshot of the incidencies of all nodes with a GlobalRouter
+   */
+  RoutingGraph();
+
+  /**
+   * @brief Reload the metrics of all edges from their faces
+   */
+  void
+  RefreshMetrics();
+
+  uint32_t
+  GetNVertices() const
+  {
+    return m_routers.size();
+  }
+
+  uint32_t
+  GetNEdges() const
+  {
+    return m_targets.size();
+  }
+
+  Ptr<GlobalRouter>
+  GetRouter(uint32_t v) const
+  {
+    return m_routers[v];
+  }
+
+  Ptr<Node>
+  GetNode(uint32_t v) const
+  {
+    return m_nodes[v];
+  }
+
+  uint32_t
+  EdgesBegin(uint32_t v) const
+  {
+    return m_offsets[v];
+  }
+
+  uint32_t
+  EdgesEnd(uint32_t v) const
+  {
+    return m_offsets[v+1];
+  }
+
+  uint32_t
+  GetTarget(uint32_t e) const
+  {
+    return m_targets[e];
+  }
+
+  uint16_t
+  GetMetric(uint32_t e) const
+  {
+    return m_metrics[e];
+  }
+
+  const shared_ptr<Face>&
+  GetFace(uint32_t e) const
+  {
+    return m_faces[e];
+  }
+
+  /**
+   * @brief Calculate the shortest path tree rooted at source
+   * @param firstEdge if not negative, the only out-edge of source that paths may start with
+   *
+   * Results are kept until the next call.
+   */
+  void
+  ShortestPaths(uint32_t source, int32_t firstEdge = -1);
+
+  /**
+   * @brief Distance from the last source, UNREACHABLE if there is no path
+   */
+  uint32_t
+  GetDistance(uint32_t v) const
+  {
+    return m_distances[v];
+  }
+
+  /**
+   * @brief Out-edge of the last source that the shortest path to v starts with, -1 if there is
+   *        none (unreachable, or v is the source)
+   */
+  int32_t
+  GetFirstHop(uint32_t v) const
+  {
+    return m_firstHops[v];
+  }
+
+private:
+  void
+  HeapPush(uint32_t v);
+
+  uint32_t
+  HeapPop();
+
+  void
+  HeapSiftUp(uint32_t i);
+
+  void
+  HeapSiftDown(uint32_t i);
+
+private:
+  vector<Ptr<GlobalRouter>> m_routers;
+  vector<Ptr<Node>> m_nodes;
+
+  vector<uint32_t> m_offsets; // [nVertices+1]
+  vector<uint32_t> m_targets; // [nEdges]
+  vector<uint16_t> m_metrics; // [nEdges]
+  vector<shared_ptr<Face>> m_faces; // [nEdges], only dereferenced when routes are installed
+
+  vector<uint32_t> m_distances;
+  vector<int32_t> m_firstHops;
+  vector<uint32_t> m_heap; // vertices, ordered by distance
+  vector<int32_t> m_heapPositions; // position of each vertex in m_heap, -1 if not queued
+};
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_ROUTING_GRAPH_HPP
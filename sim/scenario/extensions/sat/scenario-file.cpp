@@ -0,0 +1,222 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "scenario-file.hpp"
+#include "partition.hpp"
+
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/point-to-point-helper.h"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.ScenarioFile");
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+const uint32_t ScenarioFile::MAGIC;
+const uint32_t ScenarioFile::VERSION;
+
+ScenarioFile::ScenarioFile(const string& filename)
+  : m_filename(filename)
+  , m_data(MAP_FAILED)
+  , m_size(0)
+{
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    NS_FATAL_ERROR("Cannot open scenario file " << filename);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    ::close(fd);
+    NS_FATAL_ERROR("Scenario file " << filename << " is truncated");
+  }
+  m_size = st.st_size;
+  m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (m_data == MAP_FAILED) {
+    NS_FATAL_ERROR("Cannot map scenario file " << filename);
+  }
+
+  const uint8_t* base = static_cast<const uint8_t*>(m_data);
+  m_header = reinterpret_cast<const Header*>(base);
+  if (m_header->magic != MAGIC) {
+    NS_FATAL_ERROR(filename << " is not a scenario file");
+  }
+  if (m_header->version != VERSION) {
+    NS_FATAL_ERROR("Unsupported scenario file version " << m_header->version << " in " << filename
+                   << ", expecting " << VERSION);
+  }
+
+  // locate sections, all sizes are computed in 64 bits to catch corrupted counts
+  uint64_t offset = sizeof(Header);
+  uint64_t nNodes = static_cast<uint64_t>(m_header->nSatellites) + m_header->nStations;
+  auto section = [&] (uint64_t bytes) {
+    const uint8_t* p = base + offset;
+    offset += bytes;
+    if (offset > m_size) {
+      NS_FATAL_ERROR("Scenario file " << filename << " is truncated");
+    }
+    return p;
+  };
+
+  m_nameOffsets = reinterpret_cast<const uint32_t*>(section(4 * (nNodes + 1)));
+  m_names = reinterpret_cast<const char*>(section((m_header->nameBytes + 3) / 4 * 4));
+  m_isls = reinterpret_cast<const uint32_t*>(section(8 * static_cast<uint64_t>(m_header->nIsls)));
+  m_islEpochTimes = reinterpret_cast<const int32_t*>(section(4 * static_cast<uint64_t>(m_header->nIslEpochs)));
+  m_islDelays = reinterpret_cast<const uint32_t*>(section(4 * static_cast<uint64_t>(m_header->nIslEpochs) * m_header->nIsls));
+  m_userLinkDelays = reinterpret_cast<const uint32_t*>(section(4 * static_cast<uint64_t>(m_header->nStations) * m_header->nUserLinkEpochs));
+  m_attachmentOffsets = reinterpret_cast<const uint32_t*>(section(4 * (static_cast<uint64_t>(m_header->nStations) + 1)));
+  m_attachments = reinterpret_cast<const Attachment*>(section(8 * static_cast<uint64_t>(m_header->nAttachments)));
+  m_pairs = reinterpret_cast<const uint32_t*>(section(8 * static_cast<uint64_t>(m_header->nPairs)));
+  m_routeOffsets = reinterpret_cast<const uint32_t*>(section(4 * (static_cast<uint64_t>(m_header->nPairs) + 1)));
+  m_routeTimes = reinterpret_cast<const int32_t*>(section(4 * static_cast<uint64_t>(m_header->nRoutes)));
+  m_hopOffsets = reinterpret_cast<const uint32_t*>(section(4 * (static_cast<uint64_t>(m_header->nRoutes) + 1)));
+  m_hops = reinterpret_cast<const uint32_t*>(section(4 * static_cast<uint64_t>(m_header->nHops)));
+
+  if (offset != m_size) {
+    NS_FATAL_ERROR("Scenario file " << filename << " has " << m_size - offset << " trailing bytes");
+  }
+  if (m_nameOffsets[nNodes] != m_header->nameBytes ||
+      m_attachmentOffsets[m_header->nStations] != m_header->nAttachments ||
+      m_routeOffsets[m_header->nPairs] != m_header->nRoutes ||
+      m_hopOffsets[m_header->nRoutes] != m_header->nHops) {
+    NS_FATAL_ERROR("Scenario file " << filename << " has inconsistent section offsets");
+  }
+
+  NS_LOG_INFO("Mapped scenario file " << filename << ": " << m_header->nSatellites << " satellites, "
+              << m_header->nStations << " stations, " << m_header->nIsls << " ISLs, "
+              << m_header->nPairs << " pairs");
+}
+
+ScenarioFile::~ScenarioFile()
+{
+  if (m_data != MAP_FAILED) {
+    ::munmap(m_data, m_size);
+  }
+}
+
+string
+ScenarioFile::GetNodeName(uint32_t nodeIdx) const
+{
+  NS_ASSERT(nodeIdx < GetNNodes());
+  return string(m_names + m_nameOffsets[nodeIdx], m_nameOffsets[nodeIdx+1] - m_nameOffsets[nodeIdx]);
+}
+
+int32_t
+ScenarioFile::FindNode(const string& name) const
+{
+  for (uint32_t i = 0; i < GetNNodes(); i++) {
+    size_t len = m_nameOffsets[i+1] - m_nameOffsets[i];
+    if (len == name.size() && std::memcmp(m_names + m_nameOffsets[i], name.data(), len) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void
+LoadScenario(const ScenarioFile& file, NodeRegistry& registry, LinkDelays& linkDelays, uint32_t nRanks)
+{
+  // names are materialized once per node, other sections refer to nodes by index
+  vector<string> names(file.GetNNodes());
+  for (uint32_t i = 0; i < file.GetNNodes(); i++) {
+    names[i] = file.GetNodeName(i);
+  }
+
+  // nodes are created on their ranks, stations going with the first satellite they attach to
+  vector<uint32_t> satRanks = AssignSatelliteRanks(vector<string>(names.begin(), names.begin() + file.GetNSatellites()), nRanks);
+  vector<uint32_t> ranks(satRanks);
+  for (uint32_t i = 0; i < file.GetNStations(); i++) {
+    uint32_t rank = 0;
+    for (auto att = file.AttachmentsBegin(i); att != file.AttachmentsEnd(i); att++) {
+      if (att->satellite >= 0) {
+        rank = satRanks.at(att->satellite);
+        break;
+      }
+    }
+    ranks.push_back(rank);
+  }
+
+  vector<Ptr<Node>> nodes(file.GetNNodes());
+  registry.satellites.reserve(file.GetNSatellites());
+  registry.stations.reserve(file.GetNStations());
+  for (uint32_t i = 0; i < file.GetNNodes(); i++) {
+    nodes[i] = CreateObject<Node>(ranks[i]);
+    Names::Add(names[i], nodes[i]);
+    if (file.IsSatellite(i)) {
+      registry.AddSatellite(names[i], nodes[i]);
+    }
+    else {
+      registry.AddStation(names[i], nodes[i]);
+    }
+  }
+  NS_LOG_INFO("Added " << file.GetNSatellites() << " satellite nodes and " << file.GetNStations() << " station nodes");
+
+  for (uint32_t i = 0; i < file.GetNStations(); i++) {
+    auto& st = registry.stations[i];
+    st.attachments.reserve(file.AttachmentsEnd(i) - file.AttachmentsBegin(i));
+    for (auto att = file.AttachmentsBegin(i); att != file.AttachmentsEnd(i); att++) {
+      st.attachments.push_back(std::make_pair(att->time, att->satellite));
+    }
+    const uint32_t* delays = file.GetUserLinkDelays(i);
+    st.userLinkDelays.assign(delays, delays + file.GetNUserLinkEpochs());
+  }
+
+  PointToPointHelper p2p;
+  linkDelays.islChannels.reserve(file.GetNIsls());
+  for (uint32_t i = 0; i < file.GetNIsls(); i++) {
+    auto isl = file.GetIsl(i);
+    auto devices = p2p.Install(nodes[isl.first], nodes[isl.second]);
+    linkDelays.islChannels.push_back(DynamicCast<PointToPointChannel>(devices.Get(0)->GetChannel()));
+  }
+  NS_LOG_INFO("Installed " << file.GetNIsls() << " ISLs");
+
+  linkDelays.islDelays.reserve(file.GetNIslEpochs());
+  for (uint32_t i = 0; i < file.GetNIslEpochs(); i++) {
+    const uint32_t* delays = file.GetIslDelays(i);
+    linkDelays.islDelays.push_back(std::make_pair(file.GetIslEpochTime(i), vector<uint32_t>(delays, delays + file.GetNIsls())));
+  }
+  NS_LOG_INFO("Read ISL delays for " << file.GetNIslEpochs() << " epochs");
+}
+
+void
+LoadPairRoutes(const ScenarioFile& file, stationPair& stPair, const NodeRegistry& registry)
+{
+  // registry indices follow the file, see LoadScenario
+  uint32_t consumerIdx = file.GetNSatellites() + stPair.consumer;
+  uint32_t producerIdx = file.GetNSatellites() + stPair.producer;
+
+  for (uint32_t pairIdx = 0; pairIdx < file.GetNPairs(); pairIdx++) {
+    if (file.GetPair(pairIdx) != std::make_pair(consumerIdx, producerIdx)) {
+      continue;
+    }
+    stPair.routes.reserve(file.RoutesEnd(pairIdx) - file.RoutesBegin(pairIdx));
+    for (uint32_t routeIdx = file.RoutesBegin(pairIdx); routeIdx < file.RoutesEnd(pairIdx); routeIdx++) {
+      route r;
+      r.time = file.GetRouteTime(routeIdx);
+      r.hopsBegin = stPair.hops.size();
+      stPair.hops.insert(stPair.hops.end(), file.HopsBegin(routeIdx), file.HopsEnd(routeIdx));
+      r.hopsEnd = stPair.hops.size();
+      stPair.routes.push_back(r);
+    }
+    break;
+  }
+  NS_LOG_INFO("Read " << stPair.routes.size() << " routes for " << registry.stations[stPair.consumer].name
+              << " " << registry.stations[stPair.producer].name);
+}
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,271 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_SCENARIO_FILE_HPP
+#define SAT_SCENARIO_FILE_HPP
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+using std::string;
+using std::vector;
+using std::map;
+using std::pair;
+
+/**
+ * @brief Read-only, memory-mapped view of a binary scenario file generated by Leo.py (storeBinary)
+ *
+ * Nodes are interned: satellites take indices [0, nSatellites), stations take the following
+ * nStations indices, and all other sections refer to nodes by index.  All fields are 32-bit
+ * little-endian integers, laid out in the following order:
+ *
+ *   header             magic ('LEOS'), version, nSatellites, nStations, nIsls, nIslEpochs,
+ *                      nUserLinkEpochs, nPairs, nAttachments, nRoutes, nHops, nameBytes
+ *   nameOffsets        [nNodes+1], offsets of node names in names
+ *   names              [nameBytes] characters, padded to 4 bytes
+ *   isls               [nIsls] (first, second) node index pairs
+ *   islEpochTimes      [nIslEpochs] epoch (minute) of each row of islDelays
+ *   islDelays          [nIslEpochs][nIsls] delays (us), in the order of isls
+ *   userLinkDelays     [nStations][nUserLinkEpochs] delays (us) of user links, 0 if not attached
+ *   attachmentOffsets  [nStations+1], offsets of the attachments of each station
+ *   attachments        [nAttachments] (time, satellite index or -1), only changes are stored
+ *   pairs              [nPairs] (consumer, producer) node index pairs
+ *   routeOffsets       [nPairs+1], offsets of the routes of each pair
+ *   routeTimes         [nRoutes] epoch (minute) of each route
+ *   hopOffsets         [nRoutes+1], offsets of the hops of each route
+ *   hops               [nHops] satellite indices
+ */
+class ScenarioFile {
+public:
+  static const uint32_t MAGIC = 0x534f454c;
+  static const uint32_t VERSION = 1;
+
+  struct Attachment {
+    int32_t time;
+    int32_t satellite; // node index, -1 if no satellite is within range
+  };
+
+  /**
+   * @brief Map the scenario file, aborts the simulation if the file is missing or malformed
+   */
+  explicit
+  ScenarioFile(const string& filename);
+
+  ~ScenarioFile();
+
+  ScenarioFile(const ScenarioFile&) = delete;
+
+  ScenarioFile&
+  operator=(const ScenarioFile&) = delete;
+
+  uint32_t
+  GetNSatellites() const
+  {
+    return m_header->nSatellites;
+  }
+
+  uint32_t
+  GetNStations() const
+  {
+    return m_header->nStations;
+  }
+
+  uint32_t
+  GetNNodes() const
+  {
+    return m_header->nSatellites + m_header->nStations;
+  }
+
+  bool
+  IsSatellite(uint32_t nodeIdx) const
+  {
+    return nodeIdx < m_header->nSatellites;
+  }
+
+  string
+  GetNodeName(uint32_t nodeIdx) const;
+
+  /**
+   * @brief Look up a node by name (linear scan, meant for setup only), -1 if not found
+   */
+  int32_t
+  FindNode(const string& name) const;
+
+  uint32_t
+  GetNIsls() const
+  {
+    return m_header->nIsls;
+  }
+
+  pair<uint32_t, uint32_t>
+  GetIsl(uint32_t islIdx) const
+  {
+    return std::make_pair(m_isls[2*islIdx], m_isls[2*islIdx+1]);
+  }
+
+  uint32_t
+  GetNIslEpochs() const
+  {
+    return m_header->nIslEpochs;
+  }
+
+  int32_t
+  GetIslEpochTime(uint32_t epochIdx) const
+  {
+    return m_islEpochTimes[epochIdx];
+  }
+
+  /**
+   * @brief Delays (us) of all ISLs at an epoch, GetNIsls() entries
+   */
+  const uint32_t*
+  GetIslDelays(uint32_t epochIdx) const
+  {
+    return m_islDelays + static_cast<size_t>(epochIdx) * m_header->nIsls;
+  }
+
+  uint32_t
+  GetNUserLinkEpochs() const
+  {
+    return m_header->nUserLinkEpochs;
+  }
+
+  /**
+   * @brief Delays (us) of the user link of a station at each epoch, GetNUserLinkEpochs() entries
+   * @param stationIdx index among stations, i.e., node index minus GetNSatellites()
+   */
+  const uint32_t*
+  GetUserLinkDelays(uint32_t stationIdx) const
+  {
+    return m_userLinkDelays + static_cast<size_t>(stationIdx) * m_header->nUserLinkEpochs;
+  }
+
+  const Attachment*
+  AttachmentsBegin(uint32_t stationIdx) const
+  {
+    return m_attachments + m_attachmentOffsets[stationIdx];
+  }
+
+  const Attachment*
+  AttachmentsEnd(uint32_t stationIdx) const
+  {
+    return m_attachments + m_attachmentOffsets[stationIdx+1];
+  }
+
+  uint32_t
+  GetNPairs() const
+  {
+    return m_header->nPairs;
+  }
+
+  /**
+   * @brief (consumer, producer) node indices of a pair
+   */
+  pair<uint32_t, uint32_t>
+  GetPair(uint32_t pairIdx) const
+  {
+    return std::make_pair(m_pairs[2*pairIdx], m_pairs[2*pairIdx+1]);
+  }
+
+  /**
+   * @brief Index of the first route of a pair, routes of a pair span [RoutesBegin, RoutesEnd)
+   */
+  uint32_t
+  RoutesBegin(uint32_t pairIdx) const
+  {
+    return m_routeOffsets[pairIdx];
+  }
+
+  uint32_t
+  RoutesEnd(uint32_t pairIdx) const
+  {
+    return m_routeOffsets[pairIdx+1];
+  }
+
+  int32_t
+  GetRouteTime(uint32_t routeIdx) const
+  {
+    return m_routeTimes[routeIdx];
+  }
+
+  const uint32_t*
+  HopsBegin(uint32_t routeIdx) const
+  {
+    return m_hops + m_hopOffsets[routeIdx];
+  }
+
+  const uint32_t*
+  HopsEnd(uint32_t routeIdx) const
+  {
+    return m_hops + m_hopOffsets[routeIdx+1];
+  }
+
+private:
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nSatellites;
+    uint32_t nStations;
+    uint32_t nIsls;
+    uint32_t nIslEpochs;
+    uint32_t nUserLinkEpochs;
+    uint32_t nPairs;
+    uint32_t nAttachments;
+    uint32_t nRoutes;
+    uint32_t nHops;
+    uint32_t nameBytes;
+  };
+
+  string m_filename;
+  void* m_data;
+  size_t m_size;
+
+  const Header* m_header;
+  const uint32_t* m_nameOffsets;
+  const char* m_names;
+  const uint32_t* m_isls;
+  const int32_t* m_islEpochTimes;
+  const uint32_t* m_islDelays;
+  const uint32_t* m_userLinkDelays;
+  const uint32_t* m_attachmentOffsets;
+  const Attachment* m_attachments;
+  const uint32_t* m_pairs;
+  const uint32_t* m_routeOffsets;
+  const int32_t* m_routeTimes;
+  const uint32_t* m_hopOffsets;
+  const uint32_t* m_hops;
+};
+
+/**
+ * @brief Create satellite and station nodes, ISLs, link delays and attachments from a scenario file
+ *
+ * Registry indices follow the file: satellite i is node i, station i is node GetNSatellites()+i.
+ * With nRanks > 1, satellites are created on the ranks given by AssignSatelliteRanks, and stations on
+ * the rank of the first satellite they attach to.
+ */
+void
+LoadScenario(const ScenarioFile& file, NodeRegistry& registry, LinkDelays& linkDelays, uint32_t nRanks = 1);
+
+/**
+ * @brief Read the routes between a pair of stations into stPair, no routes if the pair is not in the scenario file
+ */
+void
+LoadPairRoutes(const ScenarioFile& file, stationPair& stPair, const NodeRegistry& registry);
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_SCENARIO_FILE_HPP
@@ -0,0 +1,139 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "sweep.hpp"
+
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.Sweep");
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+vector<vector<string>>
+ReadSweepFile(const string& filename)
+{
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    NS_FATAL_ERROR("Cannot open sweep file " << filename);
+  }
+
+  vector<vector<string>> points;
+  string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    vector<string> options;
+    string option;
+    while (fields >> option) {
+      options.push_back(option);
+    }
+    if (options.empty() || options.front()[0] == '#') {
+      continue;
+    }
+    points.push_back(std::move(options));
+  }
+  NS_LOG_INFO("Read " << points.size() << " sweep points from " << filename);
+  return points;
+}
+
+string
+GetSweepPointName(const vector<string>& options)
+{
+  string name;
+  for (const auto& option : options) {
+    size_t begin = option.find_first_not_of('-');
+    if (begin == string::npos) {
+      continue;
+    }
+    string field = option.substr(begin);
+    std::replace(field.begin(), field.end(), '=', '_');
+    name += field + "-";
+  }
+  return name;
+}
+
+size_t
+RunForked(size_t nPoints, unsigned nJobs, const std::function<int(size_t)>& runPoint)
+{
+  nJobs = std::max(nJobs, 1u);
+
+  // buffered output would be written again by every child
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+
+  std::map<pid_t, size_t> running; // child => point
+  size_t nextPoint = 0;
+  size_t nFailed = 0;
+  while (nextPoint < nPoints || !running.empty()) {
+    if (nextPoint < nPoints && running.size() < nJobs) {
+      pid_t pid = ::fork();
+      if (pid == 0) {
+        int status = runPoint(nextPoint);
+        std::cout.flush();
+        std::exit(status);
+      }
+      if (pid > 0) {
+        NS_LOG_INFO("Forked " << pid << " for sweep point " << nextPoint);
+        running[pid] = nextPoint++;
+        continue;
+      }
+      if (running.empty()) {
+        std::cerr << "Cannot fork for sweep point " << nextPoint << ": " << std::strerror(errno) << std::endl;
+        nextPoint++;
+        nFailed++;
+        continue;
+      }
+      // out of processes, wait for a running point to finish and retry
+    }
+
+    int status = 0;
+    pid_t pid = ::waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      NS_FATAL_ERROR("Cannot wait for sweep points: " << std::strerror(errno));
+    }
+    auto child = running.find(pid);
+    if (child == running.end()) {
+      continue;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::cerr << "Sweep point " << child->second << " failed ("
+                << (WIFEXITED(status) ? "exit status " + std::to_string(WEXITSTATUS(status))
+                                      : "signal " + std::to_string(WTERMSIG(status)))
+                << ")" << std::endl;
+      nFailed++;
+    }
+    else {
+      std::cerr << "Sweep point " << child->second << " done" << std::endl;
+    }
+    running.erase(child);
+  }
+  return nFailed;
+}
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,59 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_SWEEP_HPP
+#define SAT_SWEEP_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+using std::string;
+using std::vector;
+
+/**
+ * @brief Read the points of a parameter sweep, each point being a list of command line options
+ *
+ * The file has a point per line, with options (e.g., --strategy=hint) separated by spaces.
+ * Empty lines and lines starting with # are skipped.  Aborts the simulation if the file cannot
+ * be read.
+ */
+vector<vector<string>>
+ReadSweepFile(const string& filename);
+
+/**
+ * @brief Result prefix of a sweep point named after its options, as run.py names its runs
+ *
+ * For example, {"--run=1", "--strategy=hint"} gives "run_1-strategy_hint-".
+ */
+string
+GetSweepPointName(const vector<string>& options);
+
+/**
+ * @brief Run the points of a sweep in forked processes, at most nJobs at a time
+ *
+ * The children share the state of the calling process copy-on-write, typically a topology with
+ * installed stacks, so it is set up only once for the whole sweep.  Each child calls runPoint with
+ * the index of its point, then exits with the returned status, running the static destructors
+ * that flush the traces.  The simulator must not have been run past time 0 when this is called.
+ *
+ * @returns number of points that failed, i.e., whose child exited with a non-zero status or
+ *          could not be forked
+ */
+size_t
+RunForked(size_t nPoints, unsigned nJobs, const std::function<int(size_t)>& runPoint);
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_SWEEP_HPP
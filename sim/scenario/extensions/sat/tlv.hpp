@@ -9,9 +9,9 @@ namespace tlv {
 enum {
   AdaptationPacket = 600,
   PacketType = 601,
-  LinkId = 602, // string
+  LinkId = 602, // int
   HopLimit = 603, // int
-  TunnelId = 604, // string
+  TunnelId = 604, // int
   Payload = 605
 };
 
@@ -0,0 +1,413 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "trace-sink.hpp"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.TraceSink");
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+const uint32_t BinaryTraceSink::MAGIC;
+const uint32_t BinaryTraceSink::VERSION;
+const uint32_t BinaryTraceSink::STRINGS_BLOCK;
+const uint32_t BinaryTraceSink::CHUNK_BLOCK;
+
+static const size_t STREAM_BUFFER_SIZE = 1 << 20;
+
+static string g_format = "text";
+
+static size_t
+Padding(size_t size)
+{
+  return (8 - size % 8) % 8;
+}
+
+void
+TraceSink::SetFormat(const string& format)
+{
+  if (format != "text" && format != "binary") {
+    NS_FATAL_ERROR("Unknown trace format " << format << ", expected text or binary");
+  }
+  g_format = format;
+}
+
+const string&
+TraceSink::GetFormat()
+{
+  return g_format;
+}
+
+shared_ptr<TraceSink>
+TraceSink::Open(const string& file, const Columns& columns)
+{
+  if (file == "-") {
+    return make_shared<TextTraceSink>(shared_ptr<std::ostream>(&std::cout, std::bind([]{})), columns);
+  }
+
+  if (g_format == "binary") {
+    auto sink = make_shared<BinaryTraceSink>(file, columns);
+    if (!sink->IsOpen()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return nullptr;
+    }
+    return sink;
+  }
+
+  shared_ptr<std::ofstream> os(new std::ofstream());
+  os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+  if (!os->is_open()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+    return nullptr;
+  }
+  return make_shared<TextTraceSink>(os, columns);
+}
+
+TraceSink::TraceSink(const Columns& columns)
+  : m_columns(columns)
+{
+}
+
+TextTraceSink::TextTraceSink(shared_ptr<std::ostream> os, const Columns& columns,
+                             bool printHeader, char separator)
+  : TraceSink(columns)
+  , m_os(os)
+  , m_separator(separator)
+  , m_field(0)
+{
+  if (!printHeader) {
+    return;
+  }
+  // *m_l3RateTrace << "# "; // not necessary for R's read.table
+  for (const auto& column : m_columns) {
+    AddString(column.name);
+  }
+  EndRecord();
+}
+
+void
+TextTraceSink::Separate()
+{
+  NS_ASSERT(m_field < m_columns.size());
+  if (m_field++ > 0) {
+    *m_os << m_separator;
+  }
+}
+
+void
+TextTraceSink::AddInteger(int64_t value)
+{
+  Separate();
+  *m_os << value;
+}
+
+void
+TextTraceSink::AddReal(double value)
+{
+  Separate();
+  *m_os << value;
+}
+
+void
+TextTraceSink::AddString(const string& value)
+{
+  Separate();
+  if (m_separator != ',') {
+    *m_os << value;
+    return;
+  }
+
+  *m_os << '"';
+  for (char c : value) {
+    if (c == '"') {
+      *m_os << '"';
+    }
+    *m_os << c;
+  }
+  *m_os << '"';
+}
+
+void
+TextTraceSink::EndRecord()
+{
+  NS_ASSERT(m_field == m_columns.size());
+  *m_os << "\n";
+  m_field = 0;
+}
+
+void
+TextTraceSink::Flush()
+{
+  m_os->flush();
+}
+
+BinaryTraceSink::BinaryTraceSink(const string& file, const Columns& columns,
+                                 uint32_t rowsPerChunk)
+  : TraceSink(columns)
+  , m_buffer(STREAM_BUFFER_SIZE)
+  , m_rowsPerChunk(rowsPerChunk)
+  , m_values(columns.size())
+  , m_field(0)
+  , m_nRows(0)
+{
+  // the buffer has to be set before the file is opened
+  m_os.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+  m_os.open(file.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!m_os.is_open()) {
+    return;
+  }
+
+  for (auto& values : m_values) {
+    values.reserve(m_rowsPerChunk);
+  }
+
+  uint32_t header[] = {MAGIC, VERSION, static_cast<uint32_t>(m_columns.size())};
+  m_os.write(reinterpret_cast<const char*>(header), sizeof(header));
+  WritePadded(nullptr, sizeof(header));
+  for (const auto& column : m_columns) {
+    uint32_t columnHeader[] = {column.type, static_cast<uint32_t>(column.name.size())};
+    m_os.write(reinterpret_cast<const char*>(columnHeader), sizeof(columnHeader));
+    WritePadded(column.name.data(), column.name.size());
+  }
+}
+
+BinaryTraceSink::~BinaryTraceSink()
+{
+  if (m_os.is_open()) {
+    Flush();
+    m_os.close();
+  }
+}
+
+void
+BinaryTraceSink::WritePadded(const void* data, size_t size)
+{
+  static const char zeros[8] = {};
+  if (data != nullptr) {
+    m_os.write(static_cast<const char*>(data), size);
+  }
+  m_os.write(zeros, Padding(size));
+}
+
+void
+BinaryTraceSink::AddInteger(int64_t value)
+{
+  NS_ASSERT(m_field < m_columns.size() && m_columns[m_field].type == INTEGER);
+  m_values[m_field++].push_back(static_cast<uint64_t>(value));
+}
+
+void
+BinaryTraceSink::AddReal(double value)
+{
+  NS_ASSERT(m_field < m_columns.size() && m_columns[m_field].type == REAL);
+  uint64_t raw;
+  std::memcpy(&raw, &value, sizeof(raw));
+  m_values[m_field++].push_back(raw);
+}
+
+void
+BinaryTraceSink::AddString(const string& value)
+{
+  NS_ASSERT(m_field < m_columns.size() && m_columns[m_field].type == STRING);
+  auto it = m_stringIds.find(value);
+  if (it == m_stringIds.end()) {
+    it = m_stringIds.insert(std::make_pair(value, m_stringIds.size())).first;
+    m_newStrings.push_back(&it->first);
+  }
+  m_values[m_field++].push_back(it->second);
+}
+
+void
+BinaryTraceSink::EndRecord()
+{
+  NS_ASSERT(m_field == m_columns.size());
+  m_field = 0;
+  if (++m_nRows >= m_rowsPerChunk) {
+    Flush();
+  }
+}
+
+void
+BinaryTraceSink::Flush()
+{
+  NS_ASSERT(m_field == 0);
+  if (!m_os.is_open() || m_nRows == 0) {
+    return;
+  }
+
+  if (!m_newStrings.empty()) {
+    uint32_t block[] = {STRINGS_BLOCK, static_cast<uint32_t>(m_newStrings.size())};
+    m_os.write(reinterpret_cast<const char*>(block), sizeof(block));
+    size_t size = 0;
+    for (const string* value : m_newStrings) {
+      uint32_t length = value->size();
+      m_os.write(reinterpret_cast<const char*>(&length), sizeof(length));
+      m_os.write(value->data(), value->size());
+      size += sizeof(length) + length;
+    }
+    WritePadded(nullptr, size);
+    m_newStrings.clear();
+  }
+
+  uint32_t block[] = {CHUNK_BLOCK, m_nRows};
+  m_os.write(reinterpret_cast<const char*>(block), sizeof(block));
+  std::vector<uint32_t> ids;
+  for (size_t i = 0; i < m_columns.size(); i++) {
+    auto& values = m_values[i];
+    NS_ASSERT(values.size() == m_nRows);
+    if (m_columns[i].type == STRING) {
+      ids.assign(values.begin(), values.end());
+      WritePadded(ids.data(), ids.size() * sizeof(uint32_t));
+    }
+    else {
+      WritePadded(values.data(), values.size() * sizeof(uint64_t));
+    }
+    values.clear();
+  }
+  m_nRows = 0;
+  m_os.flush();
+}
+
+BinaryTraceReader::BinaryTraceReader(const string& file)
+  : m_file(file)
+  , m_nRows(0)
+{
+  m_is.open(file.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!m_is.is_open()) {
+    NS_FATAL_ERROR("Cannot open trace " << file);
+  }
+
+  uint32_t header[3];
+  ReadPadded(header, sizeof(header));
+  if (header[0] != BinaryTraceSink::MAGIC || header[1] != BinaryTraceSink::VERSION) {
+    NS_FATAL_ERROR(file << " is not a binary trace of version " << BinaryTraceSink::VERSION);
+  }
+
+  m_columns.resize(header[2]);
+  for (auto& column : m_columns) {
+    uint32_t columnHeader[2];
+    m_is.read(reinterpret_cast<char*>(columnHeader), sizeof(columnHeader));
+    if (columnHeader[0] > TraceSink::STRING) {
+      NS_FATAL_ERROR("Unknown column type " << columnHeader[0] << " in " << file);
+    }
+    column.type = static_cast<TraceSink::Type>(columnHeader[0]);
+    column.name.resize(columnHeader[1]);
+    ReadPadded(&column.name[0], column.name.size());
+  }
+  m_values.resize(m_columns.size());
+}
+
+void
+BinaryTraceReader::ReadPadded(void* data, size_t size)
+{
+  char padding[8];
+  m_is.read(static_cast<char*>(data), size);
+  m_is.read(padding, Padding(size));
+  if (!m_is) {
+    NS_FATAL_ERROR("Truncated trace " << m_file);
+  }
+}
+
+bool
+BinaryTraceReader::ReadChunk()
+{
+  uint32_t block[2];
+  while (m_is.read(reinterpret_cast<char*>(block), sizeof(block))) {
+    if (block[0] == BinaryTraceSink::STRINGS_BLOCK) {
+      size_t size = 0;
+      for (uint32_t i = 0; i < block[1]; i++) {
+        uint32_t length;
+        m_is.read(reinterpret_cast<char*>(&length), sizeof(length));
+        string value(length, '\0');
+        m_is.read(&value[0], length);
+        m_strings.push_back(std::move(value));
+        size += sizeof(length) + length;
+      }
+      m_is.ignore(Padding(size));
+      if (!m_is) {
+        NS_FATAL_ERROR("Truncated trace " << m_file);
+      }
+      continue;
+    }
+
+    if (block[0] != BinaryTraceSink::CHUNK_BLOCK) {
+      NS_FATAL_ERROR("Unknown block " << block[0] << " in " << m_file);
+    }
+    m_nRows = block[1];
+    for (size_t i = 0; i < m_columns.size(); i++) {
+      size_t width = m_columns[i].type == TraceSink::STRING ? sizeof(uint32_t) : sizeof(uint64_t);
+      m_values[i].resize(m_nRows * width);
+      ReadPadded(m_values[i].data(), m_values[i].size());
+    }
+    return true;
+  }
+
+  if (m_is.gcount() != 0) {
+    NS_FATAL_ERROR("Truncated trace " << m_file);
+  }
+  m_nRows = 0;
+  return false;
+}
+
+int64_t
+BinaryTraceReader::GetInteger(uint32_t column, uint32_t row) const
+{
+  NS_ASSERT(m_columns[column].type == TraceSink::INTEGER && row < m_nRows);
+  int64_t value;
+  std::memcpy(&value, m_values[column].data() + row * sizeof(value), sizeof(value));
+  return value;
+}
+
+double
+BinaryTraceReader::GetReal(uint32_t column, uint32_t row) const
+{
+  NS_ASSERT(m_columns[column].type == TraceSink::REAL && row < m_nRows);
+  double value;
+  std::memcpy(&value, m_values[column].data() + row * sizeof(value), sizeof(value));
+  return value;
+}
+
+const string&
+BinaryTraceReader::GetString(uint32_t column, uint32_t row) const
+{
+  NS_ASSERT(m_columns[column].type == TraceSink::STRING && row < m_nRows);
+  uint32_t id;
+  std::memcpy(&id, m_values[column].data() + row * sizeof(id), sizeof(id));
+  if (id >= m_strings.size()) {
+    NS_FATAL_ERROR("Undefined string " << id << " in " << m_file);
+  }
+  return m_strings[id];
+}
+
+void
+BinaryTraceReader::CopyValue(uint32_t column, uint32_t row, TraceSink& sink) const
+{
+  switch (m_columns[column].type) {
+  case TraceSink::INTEGER:
+    sink.AddInteger(GetInteger(column, row));
+    break;
+  case TraceSink::REAL:
+    sink.AddReal(GetReal(column, row));
+    break;
+  case TraceSink::STRING:
+    sink.AddString(GetString(column, row));
+    break;
+  }
+}
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,273 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_TRACE_SINK_HPP
+#define SAT_TRACE_SINK_HPP
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+using std::string;
+using std::vector;
+
+/**
+ * @brief Destination of the records of a tracer, one value per column and record
+ *
+ * Two backends exist:
+ * - text (default): tab-separated values with a header line, as read by graphs/graph-style.R
+ * - binary: column chunks of fixed-width values, see BinaryTraceSink; converted offline with the
+ *   trace-convert program
+ */
+class TraceSink {
+public:
+  enum Type : uint32_t {
+    INTEGER = 0, // int64
+    REAL = 1,    // double
+    STRING = 2   // dictionary-encoded in the binary format
+  };
+
+  struct Column {
+    string name;
+    Type type;
+  };
+
+  typedef vector<Column> Columns;
+
+  /**
+   * @brief Select the backend of sinks opened afterwards, "text" or "binary"
+   */
+  static void
+  SetFormat(const string& format);
+
+  static const string&
+  GetFormat();
+
+  /**
+   * @brief Open a sink with the current backend
+   * @param file file to which records will be written, if file is - then std::cout is used (always
+   *        as text)
+   * @return nullptr if the file cannot be opened
+   */
+  static shared_ptr<TraceSink>
+  Open(const string& file, const Columns& columns);
+
+  explicit
+  TraceSink(const Columns& columns);
+
+  virtual
+  ~TraceSink() = default;
+
+  const Columns&
+  GetColumns() const
+  {
+    return m_columns;
+  }
+
+  /**
+   * @brief Values are added in column order, then the record is closed with EndRecord
+   */
+  virtual void
+  AddInteger(int64_t value) = 0;
+
+  virtual void
+  AddReal(double value) = 0;
+
+  virtual void
+  AddString(const string& value) = 0;
+
+  virtual void
+  EndRecord() = 0;
+
+  virtual void
+  Flush() = 0;
+
+protected:
+  const Columns m_columns;
+};
+
+/**
+ * @brief Tab-separated (or comma-separated, with quoted strings) text records
+ */
+class TextTraceSink : public TraceSink {
+public:
+  /**
+   * @param printHeader whether the column names are written first
+   * @param separator with ',' strings are quoted as in RFC 4180
+   */
+  TextTraceSink(shared_ptr<std::ostream> os, const Columns& columns, bool printHeader = true,
+                char separator = '\t');
+
+  virtual void
+  AddInteger(int64_t value);
+
+  virtual void
+  AddReal(double value);
+
+  virtual void
+  AddString(const string& value);
+
+  virtual void
+  EndRecord();
+
+  virtual void
+  Flush();
+
+private:
+  void
+  Separate();
+
+private:
+  shared_ptr<std::ostream> m_os;
+  char m_separator;
+  uint32_t m_field;
+};
+
+/**
+ * @brief Binary column chunks, written in large blocks
+ *
+ * All integers are little-endian, every block is padded to a multiple of 8 bytes.
+ *
+ *     header      "LEOT" version(u32) nColumns(u32), then per column: type(u32) nameLength(u32)
+ *                 name, padded to 8 bytes
+ *     block       kind(u32) count(u32), followed by
+ *       strings   (kind 1) count dictionary entries: length(u32) bytes; IDs are assigned
+ *                 sequentially from 0 over the whole file
+ *       chunk     (kind 2) count rows; for each column its count values: int64 or double (8
+ *                 bytes), or string ID (u32), each column padded to 8 bytes
+ *
+ * A strings block always precedes the first chunk that uses its entries.  Chunks are written
+ * uncompressed: values of a column are stored contiguously, so the file compresses well with a
+ * general purpose compressor after the run.
+ */
+class BinaryTraceSink : public TraceSink {
+public:
+  static const uint32_t MAGIC = 0x544f454c; // "LEOT"
+  static const uint32_t VERSION = 1;
+  static const uint32_t STRINGS_BLOCK = 1;
+  static const uint32_t CHUNK_BLOCK = 2;
+
+  /**
+   * @param rowsPerChunk number of records buffered before a chunk is written
+   */
+  BinaryTraceSink(const string& file, const Columns& columns, uint32_t rowsPerChunk = 65536);
+
+  ~BinaryTraceSink();
+
+  bool
+  IsOpen() const
+  {
+    return m_os.is_open();
+  }
+
+  virtual void
+  AddInteger(int64_t value);
+
+  virtual void
+  AddReal(double value);
+
+  virtual void
+  AddString(const string& value);
+
+  virtual void
+  EndRecord();
+
+  /**
+   * @brief Write buffered records as a chunk
+   */
+  virtual void
+  Flush();
+
+private:
+  void
+  WritePadded(const void* data, size_t size);
+
+private:
+  std::vector<char> m_buffer; // stream buffer, must outlive m_os
+  std::ofstream m_os;
+  uint32_t m_rowsPerChunk;
+
+  vector<vector<uint64_t>> m_values; // per column, raw 8-byte values or string IDs
+  uint32_t m_field;
+  uint32_t m_nRows;
+
+  std::unordered_map<string, uint32_t> m_stringIds;
+  vector<const string*> m_newStrings; // not written yet, point into m_stringIds
+};
+
+/**
+ * @brief Reader of the files written by BinaryTraceSink, one chunk at a time
+ */
+class BinaryTraceReader {
+public:
+  /**
+   * @brief Open file and read its header, fatal error if it is not a binary trace
+   */
+  explicit
+  BinaryTraceReader(const string& file);
+
+  const TraceSink::Columns&
+  GetColumns() const
+  {
+    return m_columns;
+  }
+
+  /**
+   * @brief Read the next chunk, and the strings it uses
+   * @return false at the end of the file
+   */
+  bool
+  ReadChunk();
+
+  uint32_t
+  GetNRows() const
+  {
+    return m_nRows;
+  }
+
+  int64_t
+  GetInteger(uint32_t column, uint32_t row) const;
+
+  double
+  GetReal(uint32_t column, uint32_t row) const;
+
+  const string&
+  GetString(uint32_t column, uint32_t row) const;
+
+  /**
+   * @brief Copy value to sink, according to the type of its column
+   */
+  void
+  CopyValue(uint32_t column, uint32_t row, TraceSink& sink) const;
+
+private:
+  void
+  ReadPadded(void* data, size_t size);
+
+private:
+  string m_file;
+  std::ifstream m_is;
+  TraceSink::Columns m_columns;
+  vector<string> m_strings;
+
+  uint32_t m_nRows;
+  vector<vector<char>> m_values; // per column, as stored in the chunk
+};
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_TRACE_SINK_HPP
@@ -0,0 +1,141 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include "user-link-channel.hpp"
+#include "partition.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#endif // NS3_MPI
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.UserLinkChannel");
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+NS_OBJECT_ENSURE_REGISTERED(UserLinkChannel);
+
+TypeId
+UserLinkChannel::GetTypeId()
+{
+  static TypeId tid = TypeId("ns3::ndn::sat::UserLinkChannel").SetGroupName("Sat").SetParent<PointToPointChannel>()
+                      .AddConstructor<UserLinkChannel>();
+  return tid;
+}
+
+UserLinkChannel::UserLinkChannel()
+  : m_device(nullptr)
+  , m_peer(nullptr)
+{
+}
+
+Ptr<UserLinkChannel>
+UserLinkChannel::Install(Ptr<PointToPointNetDevice> device)
+{
+  NS_ASSERT(device->GetChannel() == nullptr);
+  auto channel = CreateObject<UserLinkChannel>();
+  channel->m_device = device;
+  device->Attach(channel);
+  return channel;
+}
+
+void
+UserLinkChannel::Bind(Ptr<UserLinkChannel> channel1, Ptr<UserLinkChannel> channel2)
+{
+  channel1->Unbind();
+  channel2->Unbind();
+  channel1->m_peer = channel2;
+  channel2->m_peer = channel1;
+
+  // a new link starts with the default delay, as channels of PointToPointHelper do
+  TypeId::AttributeInformation info;
+  PointToPointChannel::GetTypeId().LookupAttributeByName("Delay", &info);
+  channel1->SetLinkDelay(DynamicCast<const TimeValue>(info.initialValue)->Get());
+
+#ifdef NS3_MPI
+  if (!IsLocalNode(channel1->m_device->GetNode()) || !IsLocalNode(channel2->m_device->GetNode())) {
+    // packets from the other rank are passed to the device by its receiver, which it keeps once it has one
+    for (auto& device : {channel1->m_device, channel2->m_device}) {
+      if (device->GetObject<MpiReceiver>() == nullptr) {
+        auto receiver = CreateObject<MpiReceiver>();
+        receiver->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, device));
+        device->AggregateObject(receiver);
+      }
+    }
+  }
+#endif // NS3_MPI
+}
+
+void
+UserLinkChannel::Unbind()
+{
+  if (m_peer != nullptr) {
+    m_peer->m_peer = nullptr;
+    m_peer = nullptr;
+  }
+}
+
+void
+UserLinkChannel::SetLinkDelay(Time delay)
+{
+  SetAttribute("Delay", TimeValue(delay));
+  if (m_peer != nullptr) {
+    m_peer->SetAttribute("Delay", TimeValue(delay));
+  }
+}
+
+bool
+UserLinkChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime)
+{
+  if (m_peer == nullptr) {
+    NS_LOG_DEBUG("Channel of " << m_device->GetAddress() << " is not bound, drop packet");
+    return false;
+  }
+
+  Ptr<PointToPointNetDevice> dst = m_peer->m_device;
+#ifdef NS3_MPI
+  if (!IsLocalNode(dst->GetNode())) {
+    MpiInterface::SendPacket(p->Copy(), Simulator::Now() + txTime + GetDelay(), dst->GetNode()->GetId(), dst->GetIfIndex());
+    return true;
+  }
+#endif // NS3_MPI
+  Simulator::ScheduleWithContext(dst->GetNode()->GetId(), txTime + GetDelay(), &PointToPointNetDevice::Receive, dst, p->Copy());
+  return true;
+}
+
+std::size_t
+UserLinkChannel::GetNDevices() const
+{
+  return 2;
+}
+
+Ptr<NetDevice>
+UserLinkChannel::GetDevice(std::size_t i) const
+{
+  NS_ASSERT(i < 2);
+  if (i == 1 && m_peer != nullptr) {
+    return m_peer->m_device;
+  }
+  return m_device;
+}
+
+void
+UserLinkChannel::DoDispose()
+{
+  m_device = nullptr;
+  m_peer = nullptr;
+  PointToPointChannel::DoDispose();
+}
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
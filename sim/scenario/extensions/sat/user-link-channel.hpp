@@ -0,0 +1,88 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#ifndef SAT_USER_LINK_CHANNEL_HPP
+#define SAT_USER_LINK_CHANNEL_HPP
+
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+namespace ndn {
+namespace sat {
+
+/**
+ * @brief Point-to-point channel of a pooled user link device, which can be re-bound to another device
+ *
+ * A PointToPointChannel connects the same two devices for its whole life. Instead, each user link
+ * device is attached once to a channel of its own, and Bind pairs the channels of two devices for
+ * an attachment, so handovers create neither channels nor devices. A packet sent on a channel is
+ * received by the device of the paired channel after the delay of the sending channel; Bind and
+ * SetLinkDelay keep the delays of both directions equal. Packets sent while unbound are dropped.
+ *
+ * The devices may be simulated by different ranks, packets are then passed by MPI as with
+ * PointToPointRemoteChannel.
+ */
+class UserLinkChannel : public PointToPointChannel {
+public:
+  static TypeId
+  GetTypeId();
+
+  UserLinkChannel();
+
+  /**
+   * @brief Attach a new channel to device, which must not have a channel yet
+   */
+  static Ptr<UserLinkChannel>
+  Install(Ptr<PointToPointNetDevice> device);
+
+  /**
+   * @brief Pair the channels of two devices, with the default delay of point-to-point channels
+   */
+  static void
+  Bind(Ptr<UserLinkChannel> channel1, Ptr<UserLinkChannel> channel2);
+
+  /**
+   * @brief Unpair the channel and its peer, if any
+   */
+  void
+  Unbind();
+
+  /**
+   * @brief Set the delay of both directions of the link
+   */
+  void
+  SetLinkDelay(Time delay);
+
+  virtual bool
+  TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime) override;
+
+  virtual std::size_t
+  GetNDevices() const override;
+
+  /**
+   * @brief The device of the channel (0), and the device of the paired channel (1), or the device
+   *        of the channel again while unbound
+   */
+  virtual Ptr<NetDevice>
+  GetDevice(std::size_t i) const override;
+
+protected:
+  virtual void
+  DoDispose() override;
+
+private:
+  Ptr<PointToPointNetDevice> m_device;
+  Ptr<UserLinkChannel> m_peer;
+};
+
+} // namespace sat
+} // namespace ndn
+} // namespace ns3
+
+#endif // SAT_USER_LINK_CHANNEL_HPP
@@ -52,6 +52,7 @@ UserLinkTransport::UserLinkTransport(Ptr<Node> node,
   : NetDeviceTransport(node, netDevice, localUri, remoteUri, false, scope, persistency, linkType)
   , m_isUserLink(false)
   , m_isGone(false)
+  , m_id(INVALID_LINK_ID)
 {
   NS_LOG_FUNCTION(this << "Creating an ndnSIM transport (SIN) instance for netDevice with URI"
                   << this->getLocalUri());
@@ -74,10 +75,7 @@ UserLinkTransport::emit(Packet&& packet)
   NS_LOG_DEBUG("Emitting packet from netDevice with URI" << this->getLocalUri());
 
   // convert NFD packet to NS3 packet
-  BlockHeader header(packet);
-
-  Ptr<ns3::Packet> ns3Packet = Create<ns3::Packet>();
-  ns3Packet->AddHeader(header);
+  Ptr<ns3::Packet> ns3Packet = BlockHeader::CreatePacket(packet.packet, m_netDevice);
 
   // send the NS3 packet
   m_netDevice->Send(ns3Packet, m_netDevice->GetBroadcast(),
@@ -93,6 +91,15 @@ UserLinkTransport::inject(Packet&& packet)
   this->receive(std::move(packet));
 }
 
+void
+UserLinkTransport::MarkGone()
+{
+  NS_LOG_DEBUG("Marking gone the user link of netDevice with URI " << this->getLocalUri());
+
+  m_isGone = true;
+  m_node->UnregisterProtocolHandler(MakeCallback(&UserLinkTransport::receiveFromNetDevice, this));
+}
+
 void
 UserLinkTransport::doSend(Packet&& packet)
 {
@@ -111,10 +118,7 @@ UserLinkTransport::doSend(Packet&& packet)
   }
 
   // convert NFD packet to NS3 packet
-  BlockHeader header(packet);
-
-  Ptr<ns3::Packet> ns3Packet = Create<ns3::Packet>();
-  ns3Packet->AddHeader(header);
+  Ptr<ns3::Packet> ns3Packet = BlockHeader::CreatePacket(packet.packet, m_netDevice);
 
   // send the NS3 packet
   m_netDevice->Send(ns3Packet, m_netDevice->GetBroadcast(),
@@ -132,12 +136,10 @@ UserLinkTransport::receiveFromNetDevice(Ptr<NetDevice> device,
   NS_LOG_FUNCTION(device << p << protocol << from << to << packetType);
 
   // Convert NS3 packet to NFD packet
-  Ptr<ns3::Packet> packet = p->Copy();
-
-  BlockHeader header;
-  packet->RemoveHeader(header);
-
-  auto nfdPacket = Packet(std::move(header.getBlock()));
+  auto nfdPacket = Packet(BlockHeader::ExtractBlock(p));
+  if (nfdPacket.packet.empty()) {
+    return;
+  }
 
   if (nfdPacket.packet.type() == tlv::AdaptationPacket) {
     if (m_doShim) {
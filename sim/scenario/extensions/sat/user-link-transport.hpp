@@ -11,6 +11,8 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/model/ndn-net-device-transport.hpp"
 
+#include "link-id-map.hpp"
+
 #include "ns3/net-device.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
@@ -46,6 +48,15 @@ public:
   void
   inject(Packet&& packet); // receive
 
+  /**
+   * @brief Mark the user link as broken, packets sent afterwards are tunnelled
+   *
+   * The transport stops receiving from its device, which returns to the pool of the node once
+   * the face is closed (see HandoverManager::RetireUserLink).
+   */
+  void
+  MarkGone();
+
 private:
   virtual void
   doSend(Packet&& packet) override;
@@ -60,7 +71,7 @@ private:
 public:
   bool m_isUserLink;
   bool m_isGone;
-  string m_id;
+  LinkId m_id;
 };
 
 } // namespace sat
@@ -10,6 +10,7 @@ import multiprocessing
 import argparse
 
 import datetime
+import time
 
 ######################################################################
 ######################################################################
@@ -25,6 +26,9 @@ parser.add_argument('-l', '--list', dest="list", action='store_true', default=Fa
 parser.add_argument('-s', '--simulate', dest="simulate", action='store_true', default=False,
                     help='Run simulation and postprocessing (false by default)')
 
+parser.add_argument('-f', '--fork', dest="fork", action='store_true', default=False,
+                    help='Run the points of a scenario as one sweep, which sets up the topology once and forks a process per point')
+
 parser.add_argument('-g', '--no-graph', dest="graph", action='store_false', default=True,
                     help='Do not build a graph for the scenario (builds a graph by default)')
 
@@ -91,6 +95,10 @@ class ConsumerScenario (Processor):
 
     def exhaust(self, params, cmdline, prefix, pos=0):
         if pos == len(params.keys()):
+            if args.fork:
+                # named by the scenario binary after its options, as prefix
+                self.points.append(cmdline)
+                return
             cmdline += ["--resPrefix=" + prefix]
             cmdline += ["--dataDir=" + self.dataDir]
             job = SimulationJob (cmdline)
@@ -128,12 +136,65 @@ class ConsumerScenario (Processor):
         sysTime = datetime.datetime.now().strftime(TIMEFORMAT)
         path = "results/" + sysTime + "/"
         os.makedirs(path)
-        self.exhaust(params, cmdline, path)
+        if args.fork:
+            self.points = []
+            self.exhaust(params, [], path)
+            sweepFile = path + "sweep.txt"
+            with open(sweepFile, "w") as f:
+                for point in self.points:
+                    f.write(" ".join(point) + "\n")
+            pool.put(SimulationJob([self.cmdLine, "--sweep=" + sweepFile, "--resPrefix=" + path, "--dataDir=" + self.dataDir]))
+        else:
+            self.exhaust(params, cmdline, path)
 
     def postprocess (self):
         # any postprocessing, if any
         pass
 
+class ScaleScenario (Processor):
+    "Wall time and peak RSS of sat-p2p against the number of pairs of the traffic matrix"
+    def __init__ (self, name, cmdLine, dataDir, maxPairs = [1, 10, 100, 1000]):
+        self.name = name
+        self.cmdLine = cmdLine
+        self.dataDir = dataDir
+        self.maxPairs = maxPairs
+
+    def simulate (self):
+        with open(self.dataDir + "/pairs.csv") as f:
+            nPairs = len(f.readlines()) - 1
+
+        TIMEFORMAT = '%Y-%m-%d_%H:%M:%S'
+        sysTime = datetime.datetime.now().strftime(TIMEFORMAT)
+        path = "results/" + sysTime + "/"
+        os.makedirs(path)
+
+        # runs are measured one at a time, outside of the pool, so that they do not compete for cores
+        lines = ["Pairs\tWallTime(s)\tMaxRSS(KiB)\tRetCode\n"]
+        for maxPairs in self.maxPairs:
+            pairs = min(maxPairs, nPairs)
+            cmdline = [self.cmdLine, "--trafficMatrix=true", "--maxPairs=" + str(pairs),
+                       "--stop=10", "--traceFormat=binary", "--shareBlocks=true",
+                       "--resPrefix=" + path + "pairs_" + str(pairs) + "-", "--dataDir=" + self.dataDir]
+            print (" ".join (cmdline))
+            start = time.time()
+            process = subprocess.Popen (cmdline)
+            _, status, usage = os.wait4 (process.pid, 0)
+            wallTime = time.time() - start
+            retcode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+            print ("result:", pairs, "pairs", wallTime, "s", usage.ru_maxrss, "KiB", retcode)
+            lines.append("%d\t%.3f\t%d\t%d\n" % (pairs, wallTime, usage.ru_maxrss, retcode))
+            if pairs == nPairs:
+                break
+
+        with open(path + "scale.txt", "w") as f:
+            f.writelines(lines)
+
+    def postprocess (self):
+        pass
+
+    def graph (self):
+        pass
+
 
 try:
     # Simulation, processing, and graph building
@@ -149,6 +210,9 @@ try:
     consumerShimScenario1 = ConsumerScenario (name="leo-consumer-shim", cmdLine=consumerCmdLine, dataDir=dataDir, doShim=False)
     consumerShimScenario1.run ()
 
+    scaleScenario = ScaleScenario (name="leo-scale", cmdLine=consumerCmdLine, dataDir=dataDir)
+    scaleScenario.run ()
+
 finally:
     pool.join ()
     pool.shutdown ()
@@ -9,224 +9,249 @@
 #include <fstream>
 #include <sstream>
 #include <experimental/filesystem>
+#include <memory>
+#include <chrono>
+#include <thread>
 
 #include "ns3/object-factory.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-helper.h"
+#include "ns3/channel-list.h"
 
 #include "ns3/ndnSIM/helper/ndn-network-region-table-helper.hpp"
+#include "ns3/ndnSIM/model/ndn-block-header.hpp"
+#include "ns3/ndnSIM/utils/mem-usage.hpp"
 
 #include "sat/common.hpp"
+#include "sat/scenario-file.hpp"
 #include "sat/global-routing-helper.hpp"
 #include "sat/handover-manager.hpp"
 #include "sat/user-link-transport.hpp"
 #include "sat/app-delay-tracer.hpp"
 #include "sat/l3-traffic-tracer.hpp"
+#include "sat/trace-sink.hpp"
+#include "sat/sweep.hpp"
+#include "sat/partition.hpp"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif // NS3_MPI
 
 NS_LOG_COMPONENT_DEFINE("ndn.sat.scene.p2p");
 
 namespace ns3 {
 
-int
-main(int argc, char* argv[])
+/**
+ * Options of a single simulation run, which may differ between the points of a sweep
+ */
+struct RunParams
 {
-  ns3::PacketMetadata::Enable(); // fix for visualizer
-
-  // Setting default parameters for PointToPoint links and channels
-  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Gbps"));
-  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms")); // default delay for any ISL
-  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("10000p"));
-
-  CommandLine cmd;
-
   uint32_t run = 1;
-  cmd.AddValue("run", "Random seed", run);
   int stopTime = 100;
-  cmd.AddValue("stop", "Simulation duration (minutes)", stopTime);
   string resPrefix = "default-";
-  cmd.AddValue("resPrefix", "Prefix for result files", resPrefix);
 
   // NDN params
   string strategy = "multicast";
-  cmd.AddValue("strategy", "The forwarding strategy to use", strategy);
   string consumerCbrFreq = "1.0";
-  cmd.AddValue("consumerCbrFreq", "Interest sending frequency for CBR consumer", consumerCbrFreq);
   string interestLifetime = "2s";
-  cmd.AddValue("interestLifetime", "Lifetime of consumer Interest, string representation", interestLifetime);
+  bool routeByDelay = false;
 
   // sat params
-  int updateInterval = 1;
-  cmd.AddValue("updateInterval", "The interval (minute) between link change checks", updateInterval);
+  int progressInterval = 1;
   uint64_t period = 1000;
-  cmd.AddValue("period", "The period (millisecond) before and after handover during which consumer is active", period);
-  string dataDir = ".";
-  cmd.AddValue("dataDir", "Path to data files including setup configuration and traces", dataDir);
   string consumerCity = "Shanghai";
-  cmd.AddValue("consumerCity", "consumer city", consumerCity);
   string producerCity = "Delhi";
-  cmd.AddValue("producerCity", "producer city", producerCity);
+  bool trafficMatrix = false;
+  uint32_t maxPairs = 0;
 
   // link service params
   bool doShim = false;
-  cmd.AddValue("doShim", "enable DRLS", doShim);
   uint64_t hopLimit = 2;
-  cmd.AddValue("hopLimit", "hop limit", hopLimit);
-
-  cmd.Parse(argc, argv);
-
-  if (consumerCity == producerCity) {
-    return -1;
-  }
 
-  NS_LOG_DEBUG("Consumer: " << consumerCity << ", producer: " << producerCity);
-
-  Config::SetGlobal("RngRun", UintegerValue(run));
-
-  ndn::sat::UserLinkTransport::m_doShim = doShim;
-  ndn::sat::HandoverManager::m_hopLimit = hopLimit;
-
-  ndn::ShowProgress(updateInterval*60, std::chrono::system_clock::now());
-
-  // read satelite and station nodes
-  NodeContainer satNodes, stNodes;
-  map<string, ndn::sat::satellite> satellites;
-  map<string, ndn::sat::station> stations;
-  map<string, vector<string>> nodesCsv = ndn::sat::readCsv(dataDir+"/nodes.csv");
-  for(size_t row = 0; row < nodesCsv.begin()->second.size(); row++) {
-    string name = nodesCsv["Name"].at(row);
-    string type = nodesCsv["Type"].at(row);
-    if (type == "Satellite") {
-      ndn::sat::satellite sat;
-      sat.name = name;
-      Ptr<Node> node = CreateObject<Node>();
-      Names::Add(name, node);
-      sat.node = node;
-      satellites[name] = sat;
-      satNodes.Add(node);
-      NS_LOG_INFO("Added satellite node " << name);
-    }
-    else {
-      ndn::sat::station st;
-      st.name = name;
-      Ptr<Node> node = CreateObject<Node>();
-      Names::Add(name, node);
-      st.node = node;
-      map<string, vector<string>> attachmentsCsv = ndn::sat::readCsv(dataDir+"/attachments_"+name+".csv");
-      vector<pair<int, string>> attachments;
-      for(size_t row = 0; row < attachmentsCsv.begin()->second.size(); row++) {
-        attachments.push_back(make_pair(std::stoi(attachmentsCsv["Time"].at(row)),
-                                                  attachmentsCsv["Satellite"].at(row)));
-      }
-      st.attachments = attachments;
-      stations[name] = st;
-      stNodes.Add(node);
-      NS_LOG_INFO("Added station node " << name);
-    }
+  void
+  AddValues(CommandLine& cmd)
+  {
+    cmd.AddValue("run", "Random seed", run);
+    cmd.AddValue("stop", "Simulation duration (minutes)", stopTime);
+    cmd.AddValue("resPrefix", "Prefix for result files", resPrefix);
+
+    cmd.AddValue("strategy", "The forwarding strategy to use, orbit-grid forwards over the ISL grid without per-epoch routes", strategy);
+    cmd.AddValue("consumerCbrFreq", "Interest sending frequency for CBR consumer", consumerCbrFreq);
+    cmd.AddValue("interestLifetime", "Lifetime of consumer Interest, string representation", interestLifetime);
+    cmd.AddValue("routeByDelay", "with the hint strategy, route to satellites over ISL delays, repairing the routes at each epoch, "
+                 "instead of over hop counts", routeByDelay);
+
+    cmd.AddValue("progressInterval", "The interval (minute) between progress reports, handovers happen at their exact times", progressInterval);
+    cmd.AddValue("period", "The period (millisecond) before and after handover during which consumer is active", period);
+    cmd.AddValue("consumerCity", "consumer city", consumerCity);
+    cmd.AddValue("producerCity", "producer city", producerCity);
+    cmd.AddValue("trafficMatrix", "simulate all pairs of pairs.csv instead of consumerCity and producerCity, "
+                 "with the Frequency of each pair if given", trafficMatrix);
+    cmd.AddValue("maxPairs", "Only simulate the first pairs of the traffic matrix, all if 0", maxPairs);
+
+    cmd.AddValue("doShim", "enable DRLS", doShim);
+    cmd.AddValue("hopLimit", "hop limit", hopLimit);
   }
+};
 
-  // read ISL setup and set up ISLs using P2P links
-  PointToPointHelper p2p;
-  map<string, vector<string>> ISLs = ndn::sat::readCsv(dataDir+"/ISLs.csv");
-  for (size_t row = 0; row < ISLs.begin()->second.size(); row++) {
-    string first = ISLs["First"].at(row);
-    string second = ISLs["Second"].at(row);
-    auto sat1 = satellites[first];
-    auto sat2 = satellites[second];
-    p2p.Install(sat1.node, sat2.node);
-    NS_LOG_INFO("Installed link between " << first << " and " << second);
+/**
+ * Set up roles, routes and apps of a run on the installed topology, then simulate it
+ */
+static int
+RunScenario(const RunParams& p, ndn::sat::NodeRegistry& registry, ndn::sat::ScenarioFile* scenarioFile,
+            ndn::sat::LinkDelays& linkDelays, const string& dataDir, const string& traceExt)
+{
+  if (!p.trafficMatrix && p.consumerCity == p.producerCity) {
+    return -1;
   }
 
-  ndn::StackHelper ndnHelper;
-  ndnHelper.UpdateFaceCreateCallback(PointToPointNetDevice::GetTypeId(), MakeCallback(&ndn::sat::SatPointToPointNetDeviceCallback));
-  ndnHelper.SetDefaultRoutes(true);
-  // ndnHelper.setCsSize(10); // may need to limit CS size
-  
-  ndnHelper.InstallAll();
+  Config::SetGlobal("RngRun", UintegerValue(p.run));
 
-  NS_LOG_INFO("Installed NDN protocol stack");
+  ndn::sat::UserLinkTransport::m_doShim = p.doShim;
+  ndn::sat::HandoverManager::m_hopLimit = p.hopLimit;
 
-  ObjectFactory handoverManagerFactory;
-  handoverManagerFactory.SetTypeId("ns3::ndn::sat::HandoverManager");
-  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
-    (*node)->AggregateObject(handoverManagerFactory.Create<ndn::sat::HandoverManager>());
-  }
+  ndn::ShowProgress(p.progressInterval*60, std::chrono::system_clock::now());
 
-  NS_LOG_INFO("Installed Handover Manager");
+  auto& satellites = registry.satellites;
+  auto& stations = registry.stations;
+  string resPrefix = p.resPrefix;
+  string strategy = p.strategy;
 
   string topPrefix = "/sat";
 
   // set forwarding strategy
   ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
-  for (auto& item : stations) {
-    ndn::StrategyChoiceHelper::Install(item.second.node, topPrefix, "/localhost/nfd/strategy/" + strategy);
+  for (auto& st : stations) {
+    ndn::StrategyChoiceHelper::Install(st.node, topPrefix, "/localhost/nfd/strategy/" + strategy);
+  }
+  bool isGrid = strategy == "orbit-grid";
+  if (isGrid) {
+    for (auto& sat : satellites) {
+      ndn::StrategyChoiceHelper::Install(sat.node, topPrefix, "/localhost/nfd/strategy/" + strategy);
+    }
+    ndn::sat::InstallGridNeighbors(&registry, topPrefix, "/nodes/sats");
   }
 
   // set up roles
 
-  // for consumer mobility scenario, currently simulates one pair of consumer and producer
-  vector<pair<string, string>> stationPairs;
-  {
-    stationPairs.push_back(make_pair("city-"+consumerCity, "city-"+producerCity)); // consumer, producer
+  // for consumer mobility scenario, one pair of consumer and producer unless a traffic matrix is given
+  vector<ndn::sat::stationPair> stationPairs;
+  if (p.trafficMatrix) {
+    stationPairs = ndn::sat::ReadTrafficMatrix(dataDir+"/pairs.csv", registry, p.maxPairs);
+    if (stationPairs.empty()) {
+      NS_LOG_ERROR("No station pair to simulate");
+      return -1;
+    }
+  }
+  else {
+    NS_LOG_DEBUG("Consumer: " << p.consumerCity << ", producer: " << p.producerCity);
+    int consumerIdx = registry.FindStation("city-"+p.consumerCity);
+    int producerIdx = registry.FindStation("city-"+p.producerCity);
+    if (consumerIdx < 0 || producerIdx < 0) {
+      NS_LOG_ERROR("Unknown consumer or producer city");
+      return -1;
+    }
+    stationPairs.push_back(ndn::sat::stationPair());
+    stationPairs.back().consumer = consumerIdx;
+    stationPairs.back().producer = producerIdx;
   }
 
-  // set station roles
-  vector<string> producerNames;
+  // set station roles, a station that both consumes and produces takes the handovers of a consumer
+  vector<size_t> producerIdxs;
+  vector<bool> isProducer(stations.size(), false);
   for (auto& stPair : stationPairs) {
-    auto& st1 = stations[stPair.first];
+    auto& st1 = stations[stPair.consumer];
     st1.isHost = true;
     st1.role = "consumer";
 
-    auto& st2 = stations[stPair.second];
+    auto& st2 = stations[stPair.producer];
     st2.isHost = true;
-    st2.role = "producer";
+    if (st2.role != "consumer") {
+      st2.role = "producer";
+    }
 
-    if (std::find(producerNames.begin(), producerNames.end(), st2.name) == producerNames.end()) {
-      producerNames.push_back(st2.name);
+    if (!isProducer[stPair.producer]) {
+      isProducer[stPair.producer] = true;
+      producerIdxs.push_back(stPair.producer);
+    }
+    if (std::find(st2.consumerStIdxs.begin(), st2.consumerStIdxs.end(), stPair.consumer) == st2.consumerStIdxs.end()) {
+      st2.consumerStIdxs.push_back(stPair.consumer);
     }
-    st2.consumerStNames.push_back(stPair.first);
   }
 
-  // read manual routes for city pairs
-  map<pair<string, string>, vector<pair<int, vector<string>>>> routes;
+  // read manual routes for city pairs, routes are stored as spans of satellite indices;
+  // not needed with orbit-grid, which only follows the attachments of producers
   for (auto& stPair : stationPairs) {
-    auto& st1 = stations[stPair.first];
-    auto& st2 = stations[stPair.second];
+    if (isGrid) {
+      break;
+    }
+    auto& st1 = stations[stPair.consumer];
+    auto& st2 = stations[stPair.producer];
+    if (scenarioFile != nullptr) {
+      ndn::sat::LoadPairRoutes(*scenarioFile, stPair, registry);
+      continue;
+    }
     map<string, vector<string>> pairRoutesCsv = ndn::sat::readCsv(dataDir+"/routes_"+st1.name+"+"+st2.name+".csv"); // consumer, producer
-    vector<pair<int, vector<string>>> pairRoutes;
+    if (pairRoutesCsv.empty()) {
+      NS_LOG_WARN("No routes for " << st1.name << " " << st2.name);
+      continue;
+    }
     for (size_t row = 0; row < pairRoutesCsv.begin()->second.size(); row++) {
-      pairRoutes.push_back(make_pair(std::stoi(pairRoutesCsv["Time"].at(row)),
-                                     ndn::sat::split(pairRoutesCsv["Route"].at(row), "|")));
+      ndn::sat::route r;
+      r.time = std::stod(pairRoutesCsv["Time"].at(row));
+      r.hopsBegin = stPair.hops.size();
+      bool isKnown = true;
+      for (auto& hop : ndn::sat::split(pairRoutesCsv["Route"].at(row), "|")) {
+        int satIdx = registry.FindSatellite(hop);
+        if (satIdx < 0) {
+          NS_LOG_WARN("Skip route at " << r.time << " for " << st1.name << " " << st2.name << ", unknown satellite " << hop);
+          isKnown = false;
+          break;
+        }
+        stPair.hops.push_back(satIdx);
+      }
+      if (!isKnown) {
+        stPair.hops.resize(r.hopsBegin);
+        continue;
+      }
+      r.hopsEnd = stPair.hops.size();
+      stPair.routes.push_back(r);
     }
-    routes[make_pair(stPair.first, stPair.second)] = pairRoutes;
-    NS_LOG_INFO("Read " << pairRoutes.size() << " routes for " << stPair.first << " " << stPair.second);
+    NS_LOG_INFO("Read " << stPair.routes.size() << " routes for " << st1.name << " " << st2.name);
   }
 
   // read producer routes
-  map<string, vector<pair<int, map<string, vector<pair<string, string>>>>>> producerRoutes;
-  for (const auto& producerName : producerNames) {
+  vector<ndn::sat::producerRoutes> producerRoutes;
+  for (auto producerIdx : producerIdxs) {
     continue;
-    auto& station = stations[producerName];
+    auto& station = stations[producerIdx];
     BOOST_ASSERT(station.isHost);
     BOOST_ASSERT(station.role == "producer");
 
     map<string, vector<string>> routesCsv = ndn::sat::readCsv(dataDir+"/routes_"+station.name+".csv");
-    vector<pair<int, map<string, vector<pair<string, string>>>>> pRoutes;
-    map<int, int> epochFlags;
+    ndn::sat::producerRoutes pRoutes;
+    pRoutes.producer = producerIdx;
+    map<double, int> epochFlags;
     for (size_t row = 0; row < routesCsv.begin()->second.size(); row++) {
-      int epoch = std::stoi(routesCsv["Time"].at(row));
+      double epoch = std::stod(routesCsv["Time"].at(row));
       string op = routesCsv["Op"].at(row);
-      string from = routesCsv["From"].at(row);
-      string to = routesCsv["To"].at(row);
+      auto from = registry.FindSatellite(routesCsv["From"].at(row));
+      auto to = registry.FindSatellite(routesCsv["To"].at(row));
+      if (from < 0 || to < 0) {
+        NS_LOG_WARN("Skip route update " << routesCsv["From"].at(row) << " " << routesCsv["To"].at(row) << " of " << station.name << ", unknown satellite");
+        continue;
+      }
       auto epochIndex = epochFlags.find(epoch);
       if (epochIndex == epochFlags.end()) {
-        pRoutes.push_back(make_pair(epoch, map<string, vector<pair<string, string>>>()));
-        pRoutes.back().second["add"] = vector<pair<string, string>>();
-        pRoutes.back().second["remove"] = vector<pair<string, string>>();
-        epochFlags[epoch] = pRoutes.size()-1;
+        pRoutes.updates.push_back(ndn::sat::routeUpdate());
+        pRoutes.updates.back().time = epoch;
+        epochFlags[epoch] = pRoutes.updates.size()-1;
       }
-      pRoutes[epochFlags[epoch]].second[op].push_back(make_pair(from, to));
+      auto& update = pRoutes.updates[epochFlags[epoch]];
+      (op == "add" ? update.add : update.remove).push_back(make_pair(from, to));
     }
-    producerRoutes[station.name] = pRoutes;
+    producerRoutes.push_back(pRoutes);
     NS_LOG_INFO("Read routes for " << station.name);
   }
 
@@ -234,78 +259,367 @@ main(int argc, char* argv[])
   ndn::sat::GlobalRoutingHelper ndnGlobalRoutingHelper;
   ndnGlobalRoutingHelper.InstallAll();
 
-  for (auto name : producerNames) {
-    auto& producer = stations[name];
+  for (auto producerIdx : producerIdxs) {
+    auto& producer = stations[producerIdx];
     string producerPrefix = topPrefix + "/" + producer.name;
 
     ndn::AppHelper producerHelper("ns3::ndn::Producer");
     producerHelper.SetPrefix(producerPrefix);
     producerHelper.SetAttribute("PayloadSize", StringValue("1024"));
+    producerHelper.SetAttribute("ReuseEncoding", BooleanValue(true));
     auto producerApps = producerHelper.Install(producer.node);
     NS_LOG_INFO("Installed apps for producer: " << producer.name << ", on prefix: " << producerPrefix);
 
     // ndnGlobalRoutingHelper.AddOrigin(producerPrefix, producer.node);
 
     producer.prefixes.push_back(producerPrefix);
+  }
 
-    for (auto cName : producer.consumerStNames) {
-      auto& consumer = stations[cName];
-      string prefix = producerPrefix + "/" + consumer.name;
-
-      // ndn::AppHelper consumerHelper("ns3::ndn::sat::Consumer");
-      // consumerHelper.SetPrefix(prefix);
-      // // consumerHelper.SetAttribute("Frequency", StringValue("1"));
-      // // consumerHelper.SetAttribute("Randomize", StringValue("uniform"));
-      // auto consumerApps = consumerHelper.Install(consumer.node);
-      // producer.consumerApps.push_back(consumerApps.Get(0));
-
-      ndn::AppHelper consumerHelper("ns3::ndn::sat::ConsumerCbr");
-      consumerHelper.SetPrefix(prefix);
-      consumerHelper.SetAttribute("Frequency", StringValue(consumerCbrFreq));
-      // consumerHelper.SetAttribute("Randomize", StringValue("uniform"));
-      auto consumerApps = consumerHelper.Install(consumer.node);
-      producer.consumerApps.push_back(consumerApps.Get(0));
-
-      ndn::sat::AppDelayTracer::Install(consumer.node, resPrefix+"app-delays-trace.txt");
+  // one consumer per pair, the delays of all consumers go to the same trace
+  NodeContainer consumerNodes;
+  vector<bool> isTraced(stations.size(), false);
+  for (auto& stPair : stationPairs) {
+    auto& producer = stations[stPair.producer];
+    auto& consumer = stations[stPair.consumer];
+    string prefix = producer.prefixes.front() + "/" + consumer.name;
+
+    // ndn::AppHelper consumerHelper("ns3::ndn::sat::Consumer");
+    // consumerHelper.SetPrefix(prefix);
+    // // consumerHelper.SetAttribute("Frequency", StringValue("1"));
+    // // consumerHelper.SetAttribute("Randomize", StringValue("uniform"));
+    // auto consumerApps = consumerHelper.Install(consumer.node);
+    // producer.consumerApps.push_back(consumerApps.Get(0));
+
+    ndn::AppHelper consumerHelper("ns3::ndn::sat::ConsumerCbr");
+    consumerHelper.SetPrefix(prefix);
+    consumerHelper.SetAttribute("Frequency", StringValue(stPair.frequency.empty() ? p.consumerCbrFreq : stPair.frequency));
+    // consumerHelper.SetAttribute("Randomize", StringValue("uniform"));
+    auto consumerApps = consumerHelper.Install(consumer.node);
+    if (consumerApps.GetN() == 0) { // simulated by another rank
+      continue;
+    }
+    producer.consumerApps.push_back(consumerApps.Get(0));
 
-      NS_LOG_INFO("Installed apps for producer: " << producer.name << ", consumer: " << consumer.name << ", on prefix: " << prefix);
+    if (!isTraced[stPair.consumer]) {
+      isTraced[stPair.consumer] = true;
+      consumerNodes.Add(consumer.node);
     }
+
+    NS_LOG_INFO("Installed apps for producer: " << producer.name << ", consumer: " << consumer.name << ", on prefix: " << prefix);
   }
+  ndn::sat::AppDelayTracer::Install(consumerNodes, resPrefix+"app-delays-trace"+traceExt);
 
   if (strategy == "hint") {
     string satTopPrefix = "/nodes/sats";
-    for (auto& item : stations) {
-      auto& station = item.second;
+    vector<bool> isOrigin(satellites.size(), false); // satellites shared by consumers are announced once
+    for (auto& station : stations) {
       if (station.role != "consumer") {
         continue;
       }
       for (auto& att : station.attachments) {
+        if (att.second < 0 || isOrigin[att.second]) {
+          continue;
+        }
+        isOrigin[att.second] = true;
         auto& satellite = satellites[att.second];
         satellite.satPrefix = satTopPrefix+"/"+satellite.name;
         ndnGlobalRoutingHelper.AddOrigin(satellite.satPrefix, satellite.node);
         ndn::NetworkRegionTableHelper::AddRegionName(satellite.node, satellite.satPrefix);
       }
     }
-    ndnGlobalRoutingHelper.CalculateRoutes();
+    if (p.routeByDelay) {
+      // routes are calculated by the first UpdateDelays, then repaired as ISL delays change
+      linkDelays.routingHelper = &ndnGlobalRoutingHelper;
+      linkDelays.distancesMap.clear();
+    }
+    else {
+      ndnGlobalRoutingHelper.CalculateRoutes();
+    }
   }
 
   ndn::sat::UpdateParams params;
-  params.interval = updateInterval;
   params.curTime = 0;
-  params.period = period;
-  ndn::sat::Update(params, &satellites, &stations, &routes, &producerRoutes);
+  params.period = p.period;
+  ndn::sat::HandoverQueue handovers;
+  ndn::sat::BuildHandoverQueue(params, &registry, &stationPairs, &producerRoutes, &handovers);
+  ndn::sat::Update(&handovers, &registry, &stationPairs, &producerRoutes);
+  ndn::sat::UpdateDelays(0, &linkDelays, &registry);
 
-  if (doShim) // generate this trace file only if DRLS is enabled
-    Simulator::Schedule(Seconds(stopTime*60-1), &ndn::sat::ShowShimOverhead, resPrefix+"overhead-count.txt");
+  if (p.doShim) // generate this trace file only if DRLS is enabled
+    Simulator::Schedule(Seconds(p.stopTime*60-1), &ndn::sat::ShowShimOverhead, resPrefix+"overhead-count"+traceExt);
 
-  ndn::sat::L3TrafficTracer::InstallAll(resPrefix+"l3-traffic-trace.txt");
+  NodeContainer localNodes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (ndn::sat::IsLocalNode(*node)) {
+      localNodes.Add(*node);
+    }
+  }
+  ndn::sat::L3TrafficTracer::Install(localNodes, resPrefix+"l3-traffic-trace"+traceExt);
 
-  Simulator::Stop(Seconds(stopTime*60));
+  Simulator::Stop(Seconds(p.stopTime*60));
   Simulator::Run();
+  NS_LOG_INFO("Simulated " << p.stopTime << "min with " << ChannelList::GetNChannels() << " channels");
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  ns3::PacketMetadata::Enable(); // fix for visualizer
+
+  // Setting default parameters for PointToPoint links and channels
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Gbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms")); // default delay for any link, overridden by per-epoch delays if provided
+  Config::SetDefault("ns3::QueueBase::MaxSize", StringValue("10000p"));
+
+  CommandLine cmd;
+
+  RunParams params;
+  params.AddValues(cmd);
+
+  string dataDir = ".";
+  cmd.AddValue("dataDir", "Path to data files including setup configuration and traces", dataDir);
+
+  // link service params
+  bool shareBlocks = false;
+  cmd.AddValue("shareBlocks", "pass NDN packets across links without encoding them, faster but pcap and packet printing "
+               "then show zero-filled payloads", shareBlocks);
+  bool forwardingOnly = true;
+  cmd.AddValue("forwardingOnly", "create NDN management and RIB on first use, nodes without apps only get the forwarder", forwardingOnly);
+
+  // trace params
+  string traceFormat = "text";
+  cmd.AddValue("traceFormat", "text, or binary column chunks to be converted with trace-convert", traceFormat);
+
+  // sweep params
+  string sweepFile = "";
+  cmd.AddValue("sweep", "File of sweep points, each line giving the run options (e.g., --strategy=hint --run=2) of a point; "
+               "the topology is set up once and each point runs in a forked process, its results prefixed by resPrefix "
+               "and the name of the point", sweepFile);
+  unsigned jobs = std::thread::hardware_concurrency();
+  cmd.AddValue("jobs", "Maximum number of sweep points simulated at a time, the number of cores by default", jobs);
+
+  // distributed simulation params
+  bool mpi = false;
+  cmd.AddValue("mpi", "simulate on the ranks of an MPI job (e.g., ./waf --run=sat-p2p --mpi=4), satellites being "
+               "partitioned by orbital planes and stations going with their first access satellite", mpi);
+
+  cmd.Parse(argc, argv);
+
+  if (mpi) {
+#ifdef NS3_MPI
+    // user links between ranks are created during the run, which null messages do not support
+    GlobalValue::Bind("SimulatorImplementationType", StringValue("ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(&argc, &argv);
+#else
+    NS_FATAL_ERROR("ns-3 is built without MPI support");
+#endif // NS3_MPI
+  }
+  uint32_t nRanks = ndn::sat::GetNRanks();
+  if (nRanks > 1) {
+    if (!sweepFile.empty()) {
+      NS_FATAL_ERROR("Sweeps cannot be forked from an MPI job");
+    }
+    // blocks are shared within a process only, packets sent to another rank must be encoded
+    shareBlocks = false;
+    // each rank traces its own nodes
+    params.resPrefix += "rank" + std::to_string(ndn::sat::GetRank()) + "-";
+  }
+
+  // parse all sweep points before the setup, so that an invalid option fails early;
+  // options missing from a point keep the value of the command line
+  vector<RunParams> points;
+  if (!sweepFile.empty()) {
+    for (auto& options : ndn::sat::ReadSweepFile(sweepFile)) {
+      RunParams point = params;
+      point.resPrefix = "";
+      CommandLine pointCmd;
+      point.AddValues(pointCmd);
+      vector<char*> pointArgv(1, argv[0]);
+      for (auto& option : options) {
+        pointArgv.push_back(&option[0]);
+      }
+      pointCmd.Parse(pointArgv.size(), pointArgv.data());
+      point.resPrefix = params.resPrefix + (point.resPrefix.empty() ? ndn::sat::GetSweepPointName(options) : point.resPrefix);
+      points.push_back(point);
+    }
+    if (points.empty()) {
+      NS_LOG_ERROR("No sweep point in " << sweepFile);
+      return -1;
+    }
+
+    // results of all points go to the directory of resPrefix
+    std::experimental::filesystem::path resDir = std::experimental::filesystem::path(params.resPrefix + "x").parent_path();
+    if (!resDir.empty()) {
+      std::experimental::filesystem::create_directories(resDir);
+    }
+  }
+  else if (!params.trafficMatrix && params.consumerCity == params.producerCity) {
+    return -1;
+  }
+
+  Config::SetGlobal("RngRun", UintegerValue(params.run));
+
+  ndn::BlockHeader::SetSharedBlocks(shareBlocks);
+  ndn::sat::TraceSink::SetFormat(traceFormat);
+  string traceExt = traceFormat == "binary" ? ".bin" : ".txt";
+
+  // read satellite and station nodes, ISLs and link delays, from the binary scenario file if Leo.py generated one
+  ndn::sat::NodeRegistry registry;
+  auto& satellites = registry.satellites;
+  auto& stations = registry.stations;
+  ndn::sat::LinkDelays linkDelays;
+  std::unique_ptr<ndn::sat::ScenarioFile> scenarioFile;
+  if (std::experimental::filesystem::exists(dataDir+"/scenario.bin")) {
+    scenarioFile.reset(new ndn::sat::ScenarioFile(dataDir+"/scenario.bin"));
+    ndn::sat::LoadScenario(*scenarioFile, registry, linkDelays, nRanks);
+  }
+  else {
+    // nodes are registered first, and created once their ranks are known from the attachments
+    map<string, vector<string>> nodesCsv = ndn::sat::readCsv(dataDir+"/nodes.csv");
+    vector<std::pair<bool, size_t>> nodeRows; // (is satellite, registry index) of each row
+    for(size_t row = 0; row < nodesCsv.begin()->second.size(); row++) {
+      string name = nodesCsv["Name"].at(row);
+      string type = nodesCsv["Type"].at(row);
+      if (type == "Satellite") {
+        nodeRows.push_back(make_pair(true, registry.AddSatellite(name, nullptr)));
+      }
+      else {
+        nodeRows.push_back(make_pair(false, registry.AddStation(name, nullptr)));
+      }
+    }
+
+    // attachments refer to satellites by index, so read them after all satellites are known
+    for (auto& st : stations) {
+      map<string, vector<string>> attachmentsCsv = ndn::sat::readCsv(dataDir+"/attachments_"+st.name+".csv");
+      for(size_t row = 0; row < attachmentsCsv.begin()->second.size(); row++) {
+        // "-" means no satellite within range, which is index -1 as well
+        auto& satName = attachmentsCsv["Satellite"].at(row);
+        int satIdx = registry.FindSatellite(satName);
+        if (satIdx < 0 && satName != "-") {
+          NS_LOG_WARN("Unknown satellite " << satName << " in attachments of " << st.name << ", taken as out of range");
+        }
+        st.attachments.push_back(make_pair(std::stod(attachmentsCsv["Time"].at(row)), satIdx));
+      }
+    }
+
+    vector<string> satNames;
+    for (auto& sat : satellites) {
+      satNames.push_back(sat.name);
+    }
+    vector<uint32_t> satRanks = ndn::sat::AssignSatelliteRanks(satNames, nRanks);
+    for (auto& nodeRow : nodeRows) {
+      if (nodeRow.first) {
+        auto& sat = satellites[nodeRow.second];
+        sat.node = CreateObject<Node>(satRanks[nodeRow.second]);
+        Names::Add(sat.name, sat.node);
+        NS_LOG_INFO("Added satellite node " << sat.name);
+      }
+      else {
+        auto& st = stations[nodeRow.second];
+        st.node = CreateObject<Node>(ndn::sat::AssignStationRank(st.attachments, satRanks));
+        Names::Add(st.name, st.node);
+        NS_LOG_INFO("Added station node " << st.name);
+      }
+    }
+
+    // read ISL setup and set up ISLs using P2P links
+    PointToPointHelper p2p;
+    map<string, vector<string>> ISLs = ndn::sat::readCsv(dataDir+"/ISLs.csv");
+    for (size_t row = 0; row < ISLs.begin()->second.size(); row++) {
+      string first = ISLs["First"].at(row);
+      string second = ISLs["Second"].at(row);
+      int satIdx1 = registry.FindSatellite(first);
+      int satIdx2 = registry.FindSatellite(second);
+      if (satIdx1 < 0 || satIdx2 < 0) {
+        // delays in ISLDelays.csv are matched to ISLs by position, so a link cannot be skipped
+        NS_FATAL_ERROR("Unknown satellite in ISL between " << first << " and " << second);
+      }
+      auto& sat1 = satellites[satIdx1];
+      auto& sat2 = satellites[satIdx2];
+      auto devices = p2p.Install(sat1.node, sat2.node);
+      linkDelays.islChannels.push_back(DynamicCast<PointToPointChannel>(devices.Get(0)->GetChannel()));
+      NS_LOG_INFO("Installed link between " << first << " and " << second);
+    }
+
+    // read per-epoch link delays, ISLs keep the default delay if not provided
+    map<string, vector<string>> ISLDelaysCsv = ndn::sat::readCsv(dataDir+"/ISLDelays.csv");
+    if (!ISLDelaysCsv.empty()) {
+      for (size_t row = 0; row < ISLDelaysCsv.begin()->second.size(); row++) {
+        vector<uint32_t> delays;
+        for (auto& delay : ndn::sat::split(ISLDelaysCsv["Delays"].at(row), "|")) {
+          delays.push_back(std::stoul(delay));
+        }
+        BOOST_ASSERT(delays.size() == linkDelays.islChannels.size());
+        linkDelays.islDelays.push_back(make_pair(std::stoi(ISLDelaysCsv["Time"].at(row)), delays));
+      }
+      NS_LOG_INFO("Read ISL delays for " << linkDelays.islDelays.size() << " epochs");
+    }
+    map<string, vector<string>> userLinkDelaysCsv = ndn::sat::readCsv(dataDir+"/userLinkDelays.csv");
+    for (auto& st : stations) {
+      auto column = userLinkDelaysCsv.find(st.name);
+      if (column == userLinkDelaysCsv.end()) {
+        continue;
+      }
+      for (auto& delay : column->second) {
+        st.userLinkDelays.push_back(std::stoul(delay));
+      }
+      NS_LOG_INFO("Read user link delays for " << st.name);
+    }
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.UpdateFaceCreateCallback(PointToPointNetDevice::GetTypeId(), MakeCallback(&ndn::sat::SatPointToPointNetDeviceCallback));
+  ndnHelper.SetDefaultRoutes(true);
+  ndnHelper.setForwardingOnly(forwardingOnly);
+  // ndnHelper.setCsSize(10); // may need to limit CS size
+
+  int64_t memBeforeInstall = MemUsage::Get();
+  auto installStart = std::chrono::steady_clock::now();
+  ndnHelper.InstallAll();
+  std::chrono::duration<double> installTime = std::chrono::steady_clock::now() - installStart;
+
+  NS_LOG_INFO("Installed NDN protocol stack on " << NodeList::GetNNodes() << " nodes in " << installTime.count() << " s, "
+              << (MemUsage::Get() - memBeforeInstall) / 1024.0 / NodeList::GetNNodes() << " KiB per node"
+              << (forwardingOnly ? " (forwarding only)" : ""));
+
+  ObjectFactory handoverManagerFactory;
+  handoverManagerFactory.SetTypeId("ns3::ndn::sat::HandoverManager");
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    (*node)->AggregateObject(handoverManagerFactory.Create<ndn::sat::HandoverManager>());
+  }
+
+  NS_LOG_INFO("Installed Handover Manager");
+
+  if (nRanks > 1) {
+    ndn::sat::InstallLookaheadLinks(registry, ndn::sat::GetMinCrossRankDelay(registry, linkDelays));
+  }
+
+  // everything above is shared by the points of a sweep
+  int status = 0;
+  if (points.empty()) {
+    status = RunScenario(params, registry, scenarioFile.get(), linkDelays, dataDir, traceExt);
+  }
+  else {
+    size_t nFailed = ndn::sat::RunForked(points.size(), jobs, [&] (size_t i) {
+        int pointStatus = RunScenario(points[i], registry, scenarioFile.get(), linkDelays, dataDir, traceExt);
+        Simulator::Destroy();
+        return pointStatus;
+      });
+    std::cerr << "Sweep of " << points.size() << " points done, " << nFailed << " failed" << std::endl;
+    status = nFailed == 0 ? 0 : 1;
+  }
 
   Simulator::Destroy();
 
-  return 0;
+#ifdef NS3_MPI
+  if (mpi) {
+    MpiInterface::Disable();
+  }
+#endif // NS3_MPI
+
+  return status;
 }
 
 } // namespace ns3
@@ -0,0 +1,230 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+#include "ns3/ndnSIM/NFD/daemon/fw/forwarder.hpp"
+
+#include "sat/common.hpp"
+#include "sat/global-routing-helper.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.scene.RoutingTest");
+
+namespace ns3 {
+
+using std::string;
+using std::vector;
+
+// next hop faces of each (node, origin prefix)
+typedef std::map<std::pair<uint32_t, string>, vector<::nfd::FaceId>> NextHops;
+
+/**
+ * @brief An ISL of the test grid, with the faces of both ends
+ */
+struct Link {
+  Ptr<Node> node1;
+  Ptr<Node> node2;
+  std::shared_ptr<::nfd::face::Face> face1;
+  std::shared_ptr<::nfd::face::Face> face2;
+};
+
+static NextHops
+SnapshotNextHops(const NodeContainer& nodes, const vector<ndn::Name>& prefixes)
+{
+  NextHops nextHops;
+  for (auto node = nodes.Begin(); node != nodes.End(); node++) {
+    auto& fib = (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+    for (const auto& prefix : prefixes) {
+      auto entry = fib.findExactMatch(prefix);
+      if (entry == nullptr || entry->getNextHops().empty()) {
+        continue;
+      }
+      auto& faces = nextHops[std::make_pair((*node)->GetId(), prefix.toUri())];
+      for (const auto& nextHop : entry->getNextHops()) {
+        faces.push_back(nextHop.getFace().getId());
+      }
+      std::sort(faces.begin(), faces.end());
+    }
+  }
+  return nextHops;
+}
+
+static void
+SetLinkMetric(Link& link, int32_t metric)
+{
+  link.face1->setMetric(metric);
+  link.face2->setMetric(metric);
+}
+
+static void
+RemoveLink(Link& link)
+{
+  for (auto& end : {std::make_pair(link.node1, link.face1), std::make_pair(link.node2, link.face2)}) {
+    auto& incidencies = end.first->GetObject<ndn::GlobalRouter>()->GetIncidencies();
+    incidencies.remove_if([&end] (const ndn::GlobalRouter::Incidency& incidency) {
+        return std::get<1>(incidency) == end.second;
+      });
+  }
+}
+
+static void
+RestoreLink(Link& link)
+{
+  auto router1 = link.node1->GetObject<ndn::GlobalRouter>();
+  auto router2 = link.node2->GetObject<ndn::GlobalRouter>();
+  router1->AddIncidency(link.face1, router2);
+  router2->AddIncidency(link.face2, router1);
+}
+
+/**
+ * Check that the routes repaired by sat::GlobalRoutingHelper::UpdateRoutes after metric changes,
+ * removed and restored ISLs have the next hops of a full CalculateRoutes, on a grid whose links
+ * have distinct power-of-two metrics so that all shortest paths are unique.
+ *
+ *     ./waf --run sat-routing-test
+ */
+int
+main(int argc, char* argv[])
+{
+  CommandLine cmd;
+  uint32_t gridSize = 3;
+  cmd.AddValue("gridSize", "Number of routers on each side of the grid, at most 3 so that metrics fit 16 bits", gridSize);
+  cmd.Parse(argc, argv);
+  if (gridSize < 2 || gridSize > 3) {
+    NS_FATAL_ERROR("gridSize must be 2 or 3");
+  }
+
+  NodeContainer nodes;
+  nodes.Create(gridSize * gridSize);
+
+  PointToPointHelper p2p;
+  vector<std::pair<uint32_t, uint32_t>> ends;
+  for (uint32_t row = 0; row < gridSize; row++) {
+    for (uint32_t col = 0; col < gridSize; col++) {
+      uint32_t i = row * gridSize + col;
+      if (col + 1 < gridSize) {
+        ends.push_back(std::make_pair(i, i + 1));
+      }
+      if (row + 1 < gridSize) {
+        ends.push_back(std::make_pair(i, i + gridSize));
+      }
+    }
+  }
+  vector<NetDeviceContainer> devices;
+  for (auto& end : ends) {
+    devices.push_back(p2p.Install(nodes.Get(end.first), nodes.Get(end.second)));
+  }
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.UpdateFaceCreateCallback(PointToPointNetDevice::GetTypeId(), MakeCallback(&ndn::sat::SatPointToPointNetDeviceCallback));
+  ndnHelper.Install(nodes);
+
+  ndn::sat::GlobalRoutingHelper routingHelper;
+  routingHelper.Install(nodes);
+  vector<ndn::Name> prefixes;
+  for (uint32_t i = 0; i < nodes.GetN(); i++) {
+    prefixes.push_back(ndn::Name("/node/" + std::to_string(i)));
+    routingHelper.AddOrigin(prefixes.back().toUri(), nodes.Get(i));
+  }
+
+  // the k-th link has metric 2^k, higher powers are left for the changes
+  vector<Link> links;
+  for (size_t k = 0; k < ends.size(); k++) {
+    Link link;
+    link.node1 = nodes.Get(ends[k].first);
+    link.node2 = nodes.Get(ends[k].second);
+    link.face1 = link.node1->GetObject<ndn::L3Protocol>()->getFaceByNetDevice(devices[k].Get(0));
+    link.face2 = link.node2->GetObject<ndn::L3Protocol>()->getFaceByNetDevice(devices[k].Get(1));
+    NS_ASSERT(link.face1 != nullptr && link.face2 != nullptr);
+    links.push_back(link);
+    SetLinkMetric(links.back(), 1 << k);
+  }
+  int32_t nextMetric = 1 << ends.size();
+
+  std::map<Ptr<Node>, boost::DistancesMap> distancesMap;
+  routingHelper.CalculateRoutes(&distancesMap);
+
+  uint32_t nFailures = 0;
+  auto check = [&] (const string& step) {
+    routingHelper.UpdateRoutes(&distancesMap);
+    NextHops repaired = SnapshotNextHops(nodes, prefixes);
+
+    for (auto node = nodes.Begin(); node != nodes.End(); node++) {
+      auto& fib = (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getFib();
+      for (const auto& prefix : prefixes) {
+        fib.erase(prefix);
+      }
+    }
+    ndn::sat::GlobalRoutingHelper::CalculateRoutes();
+    NextHops full = SnapshotNextHops(nodes, prefixes);
+
+    if (repaired != full) {
+      nFailures++;
+      std::cerr << "FAIL " << step << ": " << repaired.size() << " repaired routes, "
+                << full.size() << " calculated routes" << std::endl;
+      for (const auto& route : full) {
+        auto other = repaired.find(route.first);
+        if (other == repaired.end() || other->second != route.second) {
+          std::cerr << "  node " << route.first.first << " " << route.first.second << " differs" << std::endl;
+        }
+      }
+    }
+    else {
+      std::cout << "PASS " << step << ": " << full.size() << " routes" << std::endl;
+    }
+  };
+
+  // the cheapest link, which all trees use, gets longer
+  SetLinkMetric(links[0], nextMetric);
+  nextMetric <<= 1;
+  check("longer link");
+
+  // the most expensive link becomes the cheapest
+  SetLinkMetric(links.back(), 1);
+  check("shorter link");
+
+  RemoveLink(links[1]);
+  check("removed link");
+
+  // cut off the last router of the grid
+  vector<size_t> lastLinks;
+  for (size_t k = 0; k < links.size(); k++) {
+    if (links[k].node2 == nodes.Get(nodes.GetN() - 1)) {
+      lastLinks.push_back(k);
+      RemoveLink(links[k]);
+    }
+  }
+  check("unreachable router");
+
+  SetLinkMetric(links[lastLinks.front()], nextMetric);
+  RestoreLink(links[lastLinks.front()]);
+  check("restored link with a new metric");
+
+  RestoreLink(links[1]);
+  check("restored link");
+
+  check("no change");
+
+  Simulator::Destroy();
+  return nFailures > 0 ? 1 : 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
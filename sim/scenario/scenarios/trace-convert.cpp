@@ -0,0 +1,86 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2019 Harbin Institute of Technology, China
+ *
+ * Author: Zhongda Xia <xiazhongda@hit.edu.cn>
+ **/
+
+#include <iostream>
+#include <fstream>
+#include <functional>
+
+#include "ns3/core-module.h"
+
+#include "sat/trace-sink.hpp"
+
+NS_LOG_COMPONENT_DEFINE("ndn.sat.scene.TraceConvert");
+
+namespace ns3 {
+
+/**
+ * Convert a trace written with --traceFormat=binary to text:
+ * - tsv: the same tab-separated file the text backend writes, for graphs/graph-style.R
+ * - csv: comma-separated with quoted strings, loadable by Parquet/Arrow CSV readers
+ *
+ *     ./waf --run "trace-convert --input=default-l3-traffic-trace.bin --output=l3.csv --format=csv"
+ */
+int
+main(int argc, char* argv[])
+{
+  CommandLine cmd;
+
+  std::string input;
+  cmd.AddValue("input", "Binary trace to convert", input);
+  std::string output = "-";
+  cmd.AddValue("output", "Text file to write, - for standard output", output);
+  std::string format = "tsv";
+  cmd.AddValue("format", "tsv or csv", format);
+
+  cmd.Parse(argc, argv);
+
+  if (input.empty() || (format != "tsv" && format != "csv")) {
+    std::cerr << "Usage: trace-convert --input=<trace.bin> [--output=<file>] [--format=tsv|csv]\n";
+    return -1;
+  }
+
+  shared_ptr<std::ostream> os;
+  if (output != "-") {
+    shared_ptr<std::ofstream> file(new std::ofstream());
+    file->open(output.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!file->is_open()) {
+      std::cerr << "File " << output << " cannot be opened for writing\n";
+      return -1;
+    }
+    os = file;
+  }
+  else {
+    os = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  ndn::sat::BinaryTraceReader reader(input);
+  ndn::sat::TextTraceSink sink(os, reader.GetColumns(), true, format == "csv" ? ',' : '\t');
+
+  uint64_t nRows = 0;
+  while (reader.ReadChunk()) {
+    for (uint32_t row = 0; row < reader.GetNRows(); row++) {
+      for (uint32_t column = 0; column < reader.GetColumns().size(); column++) {
+        reader.CopyValue(column, row, sink);
+      }
+      sink.EndRecord();
+    }
+    nRows += reader.GetNRows();
+  }
+  sink.Flush();
+
+  NS_LOG_INFO("Converted " << nRows << " records of " << input);
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}